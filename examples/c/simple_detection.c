@@ -175,7 +175,7 @@ int main(int argc, char* argv[]) {
                            result->fields[i].confidence);
                 }
             } else {
-                printf("\nNo text fields extracted (OCR not implemented yet)\n");
+                printf("\nNo text fields extracted (set ocr_enabled to 1 for field OCR)\n");
             }
             
             // Free the result
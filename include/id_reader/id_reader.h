@@ -32,7 +32,11 @@ typedef enum {
     ID_READER_ERROR_PROCESSING_FAILED = -3,
     ID_READER_ERROR_NO_DOCUMENT_FOUND = -4,
     ID_READER_ERROR_UNSUPPORTED_FORMAT = -5,
-    ID_READER_ERROR_INITIALIZATION_FAILED = -6
+    ID_READER_ERROR_INITIALIZATION_FAILED = -6,
+    ID_READER_ERROR_BUFFER_TOO_SMALL = -7,
+    ID_READER_ERROR_NOT_ENABLED = -8,
+    ID_READER_ERROR_LOW_QUALITY = -9,
+    ID_READER_ERROR_CANCELLED = -10
 } id_reader_error_t;
 
 // Document types
@@ -61,16 +65,24 @@ typedef enum {
     ID_READER_IMAGE_FORMAT_RGBA = 1,
     ID_READER_IMAGE_FORMAT_BGR = 2,
     ID_READER_IMAGE_FORMAT_BGRA = 3,
-    ID_READER_IMAGE_FORMAT_GRAYSCALE = 4
+    ID_READER_IMAGE_FORMAT_GRAYSCALE = 4,
+    ID_READER_IMAGE_FORMAT_NV12 = 5,  // Y plane + interleaved UV plane (4:2:0)
+    ID_READER_IMAGE_FORMAT_NV21 = 6,  // Y plane + interleaved VU plane (4:2:0)
+    ID_READER_IMAGE_FORMAT_I420 = 7   // Y plane + separate U and V planes (4:2:0)
 } id_reader_image_format_t;
 
 // Image data structure
 typedef struct {
-    uint8_t* data;
+    uint8_t* data;    // Packed pixels, or the Y plane for YUV formats
     size_t width;
     size_t height;
-    size_t stride;
+    size_t stride;    // Bytes per row of data
     id_reader_image_format_t format;
+    // Chroma planes for YUV formats, ignored otherwise. NV12/NV21 use plane 0
+    // for the interleaved chroma; I420 uses plane 0 for U and plane 1 for V.
+    // Detection reads only the Y plane, so these may be NULL.
+    uint8_t* chroma_data[2];
+    size_t chroma_stride[2];
 } id_reader_image_t;
 
 // Document bounds
@@ -95,13 +107,121 @@ typedef struct {
     id_reader_field_t* fields;
     size_t field_count;
     float overall_confidence;
+    float document_type_confidence;  // Calibrated probability of document_type; 0 when unknown
+    float country_confidence;        // Calibrated probability of country; 0 when unknown
 } id_reader_result_t;
 
+// Caller-owned storage for the *_into processing variants. Field records are
+// written to `fields` and every field name and value is packed into
+// `string_pool`, so the library allocates nothing for the result. The
+// required_* members are set on every call to the capacity the result needed.
+typedef struct {
+    id_reader_field_t* fields;
+    size_t field_capacity;
+    char* string_pool;
+    size_t string_pool_size;
+    size_t required_field_capacity;
+    size_t required_string_pool_size;
+} id_reader_result_buffer_t;
+
+// Canonical crop produced by id_reader_rectify_document
+typedef enum {
+    ID_READER_RECTIFY_AUTO = 0,  // ID-1 or TD3, whichever the quad's aspect is closer to
+    ID_READER_RECTIFY_ID1 = 1,   // 85.60 x 53.98 mm: ID cards, driver's licenses
+    ID_READER_RECTIFY_TD3 = 2    // 125 x 88 mm: passport data pages
+} id_reader_rectify_format_t;
+
+typedef enum {
+    ID_READER_INTERPOLATION_BILINEAR = 0,
+    ID_READER_INTERPOLATION_NEAREST = 1
+} id_reader_interpolation_t;
+
+// Rectification options. A zeroed struct (or NULL) selects an automatically
+// sized, bilinear, 300 DPI luma crop.
+typedef struct {
+    id_reader_rectify_format_t format;
+    float dpi;                                // Output resolution; 0 selects 300
+    id_reader_interpolation_t interpolation;
+    bool color;                               // Keep the input's channels (packed formats only)
+} id_reader_rectify_options_t;
+
+// Caller-owned pixel storage for id_reader_rectify_document.
+// required_capacity is set on every call to the bytes the crop needed.
+typedef struct {
+    uint8_t* data;
+    size_t capacity;
+    size_t required_capacity;
+} id_reader_image_buffer_t;
+
+// Reasons a frame fails the quality thresholds (bit flags)
+typedef enum {
+    ID_READER_QUALITY_OK = 0,
+    ID_READER_QUALITY_BLURRY = 1 << 0,      // Sharpness below quality_min_sharpness
+    ID_READER_QUALITY_GLARE = 1 << 1,       // Specular area above quality_max_glare
+    ID_READER_QUALITY_TOO_DARK = 1 << 2,    // Mean luma below quality_min_brightness
+    ID_READER_QUALITY_TOO_BRIGHT = 1 << 3   // Mean luma above quality_max_brightness
+} id_reader_quality_reason_t;
+
+// Frame quality measured on a decimated luma plane
+typedef struct {
+    float score;          // 0-1; at least 0.5 when every threshold passes
+    uint32_t reasons;     // id_reader_quality_reason_t flags, 0 when acceptable
+    float sharpness;      // Variance of the Laplacian
+    float glare_ratio;    // Fraction of near-saturated pixels
+    float brightness;     // Mean luma, 0-255
+} id_reader_quality_t;
+
+// Wall-clock milliseconds spent in each stage of the most recent call
+typedef struct {
+    double ingest_ms;          // Pixel format conversion to luma
+    double quality_ms;         // Quality gate, when enabled
+    double preprocess_ms;      // Downscale, blur, edge detection, morphology
+    double contours_ms;        // Contour (or line segment) extraction and filtering
+    double quad_selection_ms;  // Best-quad search
+    double bounds_ms;          // Corner ordering and sub-pixel refinement
+    double confidence_ms;      // Detection confidence scoring
+    double rectify_ms;         // Rectified crop for field extraction
+    double mrz_ms;             // Machine readable zone reading, by templates or Tesseract
+    double barcode_ms;         // PDF417 barcode reading, including its rectified crop
+    double classify_ms;        // Document type and country classification
+    double total_ms;           // Whole call, including stages not listed
+} id_reader_stats_t;
+
 // Library context (opaque)
 typedef struct id_reader_context id_reader_context_t;
 
+// Shared processing engine and per-thread session (opaque)
+typedef struct id_reader_engine id_reader_engine_t;
+typedef struct id_reader_session id_reader_session_t;
+
+// Video stream tracking state (opaque)
+typedef struct id_reader_stream id_reader_stream_t;
+
+// Best-frame capture burst (opaque)
+typedef struct id_reader_burst id_reader_burst_t;
+
+// Handle to a queued asynchronous request (opaque)
+typedef struct id_reader_async_request id_reader_async_request_t;
+
+// Called once per asynchronous request, normally on a library worker thread;
+// requests dropped by the queue policy complete on the submitting thread.
+// result is NULL unless error is ID_READER_SUCCESS; the callback owns it and
+// frees it with id_reader_free_result.
+typedef void (*id_reader_completion_callback_t)(id_reader_error_t error, id_reader_result_t* result,
+                                                void* user_data);
+
 // Initialization and cleanup
 id_reader_error_t id_reader_init(id_reader_context_t** context);
+
+// Like id_reader_init, with the classification model, MRZ glyph templates and
+// PDF417 codeword table taken from an asset bundle (built with
+// id_reader_pack). The bundle is memory-mapped and only its index is read
+// here; each asset is paged in and decoded the first time a document needs
+// it, and contexts opening the same file share one mapping. Config keys that
+// name an asset file (classifier_model, mrz_templates, pdf417_codebook) take
+// precedence over the bundle. Returns ID_READER_ERROR_INITIALIZATION_FAILED
+// when the file is missing or not a bundle of a supported version.
+id_reader_error_t id_reader_init_with_bundle(id_reader_context_t** context, const char* bundle_path);
 void id_reader_cleanup(id_reader_context_t* context);
 
 // Configuration
@@ -115,6 +235,156 @@ id_reader_error_t id_reader_process_image(
     id_reader_result_t** result
 );
 
+// Like id_reader_process_image, but the result is written into caller-owned
+// storage. result->fields points into buffer->fields and field strings point
+// into buffer->string_pool; they stay valid until the buffer is reused. Such
+// results must not be passed to id_reader_free_result. If the fields do not
+// fit, bounds are still filled in, result->field_count is 0 and
+// ID_READER_ERROR_BUFFER_TOO_SMALL is returned. buffer may be NULL when no
+// fields are expected.
+id_reader_error_t id_reader_process_image_into(
+    id_reader_context_t* context,
+    const id_reader_image_t* image,
+    id_reader_result_t* result,
+    id_reader_result_buffer_t* buffer
+);
+
+// Batch processing on the library's worker pool (sized by the "batch_threads"
+// config key, defaulting to the number of hardware threads). results[i], and
+// errors[i] when errors is not NULL, receive the outcome for images[i] in
+// input order; images that fail leave results[i] NULL. Returns
+// ID_READER_SUCCESS once every image has been processed.
+id_reader_error_t id_reader_process_batch(
+    id_reader_context_t* context,
+    const id_reader_image_t* images,
+    size_t count,
+    id_reader_result_t** results,
+    id_reader_error_t* errors
+);
+
+// Asynchronous processing on the library's internal pipeline: detection
+// workers ("async_threads" config key, defaulting to the number of hardware
+// threads) feed extraction workers ("async_extract_threads", default 1), so
+// one image is detected while the previous one is extracted. The image is
+// copied before this returns, so its buffer may be reused immediately. When
+// "async_max_pending" images (default 2) are already waiting for detection,
+// "async_queue_policy" decides: "drop_oldest" (default) drops the oldest
+// waiting image, "drop_newest" drops the new one and "block" waits for room.
+// Dropped and cancelled requests complete with ID_READER_ERROR_CANCELLED. If
+// request is not NULL it receives a handle that must be released with
+// id_reader_async_release. id_reader_cleanup waits for running requests and
+// completes waiting ones as cancelled.
+id_reader_error_t id_reader_process_image_async(
+    id_reader_context_t* context,
+    const id_reader_image_t* image,
+    id_reader_completion_callback_t callback,
+    void* user_data,
+    id_reader_async_request_t** request
+);
+// Cancel a superseded request. One still waiting is never processed; one
+// already running has its result discarded. No effect after completion.
+void id_reader_async_cancel(id_reader_async_request_t* request);
+void id_reader_async_release(id_reader_async_request_t* request);
+
+// Shared engines for multi-threaded callers. An engine is an immutable
+// snapshot of a context's configuration that any number of threads may use at
+// once; later id_reader_set_config calls do not affect it. Each thread creates
+// its own session, which owns that thread's scratch state. Sessions keep
+// their engine alive, so the engine may be released before its sessions.
+id_reader_error_t id_reader_engine_create(id_reader_context_t* context, id_reader_engine_t** engine);
+void id_reader_engine_release(id_reader_engine_t* engine);
+id_reader_error_t id_reader_session_create(id_reader_engine_t* engine, id_reader_session_t** session);
+void id_reader_session_destroy(id_reader_session_t* session);
+id_reader_error_t id_reader_session_process_image(
+    id_reader_session_t* session,
+    const id_reader_image_t* image,
+    id_reader_result_t** result
+);
+id_reader_error_t id_reader_session_process_image_into(
+    id_reader_session_t* session,
+    const id_reader_image_t* image,
+    id_reader_result_t* result,
+    id_reader_result_buffer_t* buffer
+);
+
+// Video stream processing. Each pushed frame is searched only around the
+// document found in the previous frame; full-frame detection runs only when
+// tracking is lost. A stream snapshots its context's configuration when it
+// begins and owns its own detector state.
+id_reader_error_t id_reader_stream_begin(id_reader_context_t* context, id_reader_stream_t** stream);
+id_reader_error_t id_reader_stream_push_frame(
+    id_reader_stream_t* stream,
+    const id_reader_image_t* image,
+    id_reader_result_t** result
+);
+void id_reader_stream_end(id_reader_stream_t* stream);
+
+// Deskewed, fixed-resolution crop of the quad in `bounds` (as returned for
+// `image`) with ID-1 or TD3 proportions. The crop is always landscape: the
+// quad's longer sides become its width. On success `output` describes the
+// crop, tightly packed, as GRAYSCALE or, with options->color, in the input's
+// packed format. Pixels go to buffer->data when buffer is not NULL; if it is
+// too small, output's size and buffer->required_capacity are still filled in
+// and ID_READER_ERROR_BUFFER_TOO_SMALL is returned. With a NULL buffer the
+// pixels live in a buffer owned by the context (or session) and stay valid
+// until its next rectification call.
+id_reader_error_t id_reader_rectify_document(
+    id_reader_context_t* context,
+    const id_reader_image_t* image,
+    const id_reader_document_bounds_t* bounds,
+    const id_reader_rectify_options_t* options,
+    id_reader_image_t* output,
+    id_reader_image_buffer_t* buffer
+);
+id_reader_error_t id_reader_session_rectify_document(
+    id_reader_session_t* session,
+    const id_reader_image_t* image,
+    const id_reader_document_bounds_t* bounds,
+    const id_reader_rectify_options_t* options,
+    id_reader_image_t* output,
+    id_reader_image_buffer_t* buffer
+);
+
+// Burst capture: push frames of one document, then collect a single result.
+// Each frame is only detected and scored (sharpness, detection confidence and
+// corner stability against the previous frame); the best "burst_candidates"
+// frames (default 3) are kept, and classification and field extraction run
+// only on the winner in id_reader_burst_finish (or, when nothing can be read
+// from it, on the next best in turn). push_frame returns the
+// frame's own detection error, which does not end the burst, and writes the
+// frame's score (0 without a document) when frame_score is not NULL.
+id_reader_error_t id_reader_burst_begin(id_reader_context_t* context, id_reader_burst_t** burst);
+id_reader_error_t id_reader_burst_push_frame(id_reader_burst_t* burst, const id_reader_image_t* image,
+                                             float* frame_score);
+id_reader_error_t id_reader_burst_finish(id_reader_burst_t* burst, id_reader_result_t** result);
+// The winning frame as a GRAYSCALE image owned by the burst, valid until the
+// next push or id_reader_burst_end. bounds may be NULL.
+id_reader_error_t id_reader_burst_get_best_frame(id_reader_burst_t* burst, id_reader_image_t* frame,
+                                                 id_reader_document_bounds_t* bounds);
+void id_reader_burst_end(id_reader_burst_t* burst);
+
+// Quality assessment. id_reader_assess_quality measures an image without
+// detecting anything, so capture loops can skip frames cheaply. With the
+// "quality_gate" config key set to "1", processing calls run the same checks
+// first and return ID_READER_ERROR_LOW_QUALITY for failing frames; the
+// *_get_quality functions then report why. Thresholds come from the
+// quality_* config keys.
+id_reader_error_t id_reader_assess_quality(id_reader_context_t* context, const id_reader_image_t* image,
+                                           id_reader_quality_t* quality);
+id_reader_error_t id_reader_session_assess_quality(id_reader_session_t* session, const id_reader_image_t* image,
+                                                   id_reader_quality_t* quality);
+id_reader_error_t id_reader_get_quality(id_reader_context_t* context, id_reader_quality_t* quality);
+id_reader_error_t id_reader_session_get_quality(id_reader_session_t* session, id_reader_quality_t* quality);
+id_reader_error_t id_reader_stream_get_quality(id_reader_stream_t* stream, id_reader_quality_t* quality);
+
+// Per-stage timing of the last image processed by a context, session or
+// stream. Collection is off by default: set the "collect_stats" config key to
+// "1" before processing. Returns ID_READER_ERROR_NOT_ENABLED when collection
+// is off or the library was built without ENABLE_STAGE_TIMING.
+id_reader_error_t id_reader_get_stats(id_reader_context_t* context, id_reader_stats_t* stats);
+id_reader_error_t id_reader_session_get_stats(id_reader_session_t* session, id_reader_stats_t* stats);
+id_reader_error_t id_reader_stream_get_stats(id_reader_stream_t* stream, id_reader_stats_t* stats);
+
 // Result management
 void id_reader_free_result(id_reader_result_t* result);
 
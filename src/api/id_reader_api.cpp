@@ -9,21 +9,370 @@
  */
 
 #include "id_reader/id_reader.h"
-#include "../preprocessing/document_detection/document_detector.h"
+#include "../core/async_processor.h"
+#include "../core/burst_selector.h"
+#include "../core/engine.h"
+#include "../core/session.h"
+#include "../core/thread_pool.h"
+#include "../preprocessing/document_detection/document_tracker.h"
+#include "../preprocessing/image_ingest/image_ingest.h"
 #include <opencv2/opencv.hpp>
+#include <cstring>
 #include <memory>
 #include <string>
 #include <map>
+#include <vector>
+
+using id_reader::core::Engine;
+using id_reader::core::Session;
+using id_reader::core::ProcessingOutput;
 
 struct id_reader_context {
-    std::unique_ptr<id_reader::preprocessing::DocumentDetector> detector;
     std::map<std::string, std::string> config;
     
-    id_reader_context() {
-        detector = std::make_unique<id_reader::preprocessing::DocumentDetector>();
+    // Models and templates mapped at init, shared by every engine
+    std::shared_ptr<const id_reader::core::AssetBundle> bundle;
+    
+    // Engine snapshot of config, rebuilt on first use after a change. The
+    // default session serves id_reader_process_image.
+    std::shared_ptr<const Engine> engine;
+    std::unique_ptr<Session> session;
+    
+    // Batch processing: one session per pool worker plus one for the
+    // calling thread, which takes part in the batch
+    std::unique_ptr<id_reader::core::ThreadPool> batch_pool;
+    std::vector<std::unique_ptr<Session>> batch_sessions;
+    
+    // Asynchronous requests, created on first use
+    std::unique_ptr<id_reader::core::AsyncProcessor> async;
+};
+
+struct id_reader_engine {
+    std::shared_ptr<const Engine> engine;
+};
+
+struct id_reader_session {
+    Session session;
+    
+    explicit id_reader_session(std::shared_ptr<const Engine> engine)
+        : session(std::move(engine)) {}
+};
+
+struct id_reader_stream {
+    Session session;
+    id_reader::preprocessing::DocumentTracker tracker;
+    
+    explicit id_reader_stream(std::shared_ptr<const Engine> engine)
+        : session(std::move(engine)), tracker(session.detector()) {
+        tracker.setSearchMargin(session.engine()->settings().tracking_margin);
+        tracker.setSmoothing(session.engine()->settings().tracking_smoothing);
     }
 };
 
+struct id_reader_async_request {
+    std::shared_ptr<id_reader::core::AsyncRequest> request;
+};
+
+struct id_reader_burst {
+    id_reader::core::BurstSelector selector;
+    
+    explicit id_reader_burst(std::shared_ptr<const Engine> engine)
+        : selector(std::move(engine)) {}
+};
+
+namespace {
+
+const std::shared_ptr<const Engine>& currentEngine(id_reader_context* context) {
+    if (!context->engine) {
+        context->engine = std::make_shared<const Engine>(context->config, context->bundle);
+        context->session = std::make_unique<Session>(context->engine);
+    }
+    return context->engine;
+}
+
+void copyBounds(const ProcessingOutput& output, id_reader_result_t* result) {
+    result->document_type = output.document_type;
+    result->country = output.country;
+    result->bounds.x1 = output.bounds.x1;
+    result->bounds.y1 = output.bounds.y1;
+    result->bounds.x2 = output.bounds.x2;
+    result->bounds.y2 = output.bounds.y2;
+    result->bounds.x3 = output.bounds.x3;
+    result->bounds.y3 = output.bounds.y3;
+    result->bounds.x4 = output.bounds.x4;
+    result->bounds.y4 = output.bounds.y4;
+    result->bounds.confidence = output.bounds.confidence;
+    result->fields = nullptr;
+    result->field_count = 0;
+    result->overall_confidence = output.overall_confidence;
+    result->document_type_confidence = output.document_type_confidence;
+    result->country_confidence = output.country_confidence;
+}
+
+char* copyString(const std::string& source) {
+    char* copy = new char[source.size() + 1];
+    std::memcpy(copy, source.c_str(), source.size() + 1);
+    return copy;
+}
+
+void copyField(const id_reader::core::ExtractedField& source, char* name, char* value, id_reader_field_t& field) {
+    field.name = name;
+    field.value = value;
+    field.confidence = source.confidence;
+    field.x = source.box.x;
+    field.y = source.box.y;
+    field.width = source.box.width;
+    field.height = source.box.height;
+}
+
+id_reader_result_t* createResult(const ProcessingOutput& output) {
+    std::unique_ptr<id_reader_result_t> result(new id_reader_result_t());
+    copyBounds(output, result.get());
+    
+    // Heap results own one allocation per string, freed by id_reader_free_result
+    if (!output.fields.empty()) {
+        try {
+            result->fields = new id_reader_field_t[output.fields.size()]();
+            result->field_count = output.fields.size();
+            for (size_t i = 0; i < output.fields.size(); ++i) {
+                id_reader_field_t& target = result->fields[i];
+                target.name = copyString(output.fields[i].name);
+                target.value = copyString(output.fields[i].value);
+                copyField(output.fields[i], target.name, target.value, target);
+            }
+        } catch (...) {
+            id_reader_free_result(result.release());
+            throw;
+        }
+    }
+    return result.release();
+}
+
+id_reader_error_t writeResult(const ProcessingOutput& output,
+                              id_reader_result_t* result,
+                              id_reader_result_buffer_t* buffer) {
+    copyBounds(output, result);
+    
+    size_t pool_needed = 0;
+    for (const auto& field : output.fields) {
+        pool_needed += field.name.size() + 1 + field.value.size() + 1;
+    }
+    
+    if (buffer) {
+        buffer->required_field_capacity = output.fields.size();
+        buffer->required_string_pool_size = pool_needed;
+    }
+    if (output.fields.empty()) {
+        return ID_READER_SUCCESS;
+    }
+    if (!buffer || !buffer->fields || !buffer->string_pool ||
+        buffer->field_capacity < output.fields.size() || buffer->string_pool_size < pool_needed) {
+        return ID_READER_ERROR_BUFFER_TOO_SMALL;
+    }
+    
+    // Strings are packed back to back into the caller's pool
+    char* cursor = buffer->string_pool;
+    auto pack = [&cursor](const std::string& text) {
+        char* start = cursor;
+        std::memcpy(cursor, text.c_str(), text.size() + 1);
+        cursor += text.size() + 1;
+        return start;
+    };
+    
+    for (size_t i = 0; i < output.fields.size(); ++i) {
+        char* name = pack(output.fields[i].name);
+        char* value = pack(output.fields[i].value);
+        copyField(output.fields[i], name, value, buffer->fields[i]);
+    }
+    result->fields = buffer->fields;
+    result->field_count = output.fields.size();
+    return ID_READER_SUCCESS;
+}
+
+id_reader_error_t processImage(Session& session, const id_reader_image_t& image, id_reader_result_t** result) {
+    ProcessingOutput output;
+    id_reader_error_t error = session.processImage(image, output);
+    if (error != ID_READER_SUCCESS) {
+        return error;
+    }
+    
+    *result = createResult(output);
+    return ID_READER_SUCCESS;
+}
+
+id_reader_error_t processImageInto(Session& session,
+                                   const id_reader_image_t& image,
+                                   id_reader_result_t* result,
+                                   id_reader_result_buffer_t* buffer) {
+    // Reusing the session's output keeps its field vector's capacity
+    ProcessingOutput& output = session.output();
+    id_reader_error_t error = session.processImage(image, output);
+    if (error != ID_READER_SUCCESS) {
+        return error;
+    }
+    
+    return writeResult(output, result, buffer);
+}
+
+void prepareBatchWorkers(id_reader_context* context) {
+    const std::shared_ptr<const Engine>& engine = currentEngine(context);
+    
+    if (!context->batch_pool) {
+        context->batch_pool = std::make_unique<id_reader::core::ThreadPool>(engine->settings().batch_threads);
+        context->batch_sessions.clear();
+    }
+    
+    // Sessions are tied to the engine they were created from
+    if (context->batch_sessions.empty() || context->batch_sessions.front()->engine() != engine) {
+        size_t slots = context->batch_pool->size() + 1;
+        context->batch_sessions.clear();
+        for (size_t i = 0; i < slots; ++i) {
+            context->batch_sessions.push_back(std::make_unique<Session>(engine));
+        }
+    }
+}
+
+id_reader::preprocessing::RectifySettings rectifySettings(const id_reader_rectify_options_t& options) {
+    using id_reader::preprocessing::DocumentFormat;
+    using id_reader::preprocessing::WarpInterpolation;
+    
+    id_reader::preprocessing::RectifySettings settings;
+    settings.format = options.format == ID_READER_RECTIFY_ID1 ? DocumentFormat::Id1 :
+                      options.format == ID_READER_RECTIFY_TD3 ? DocumentFormat::Td3 : DocumentFormat::Auto;
+    if (options.dpi > 0.0f) {
+        settings.dpi = options.dpi;
+    }
+    settings.interpolation = options.interpolation == ID_READER_INTERPOLATION_NEAREST ?
+        WarpInterpolation::Nearest : WarpInterpolation::Bilinear;
+    return settings;
+}
+
+id_reader_error_t rectifyDocument(Session& session,
+                                  const id_reader_image_t& image,
+                                  const id_reader_document_bounds_t& source_bounds,
+                                  const id_reader_rectify_options_t* options,
+                                  id_reader_image_t* output,
+                                  id_reader_image_buffer_t* buffer) {
+    const id_reader_rectify_options_t defaults = {};
+    const id_reader_rectify_options_t& chosen = options ? *options : defaults;
+    id_reader::preprocessing::RectifySettings settings = rectifySettings(chosen);
+    
+    id_reader::preprocessing::DocumentBounds bounds;
+    bounds.x1 = source_bounds.x1;
+    bounds.y1 = source_bounds.y1;
+    bounds.x2 = source_bounds.x2;
+    bounds.y2 = source_bounds.y2;
+    bounds.x3 = source_bounds.x3;
+    bounds.y3 = source_bounds.y3;
+    bounds.x4 = source_bounds.x4;
+    bounds.y4 = source_bounds.y4;
+    bounds.confidence = source_bounds.confidence;
+    
+    int channels = 1;
+    id_reader_image_format_t format = ID_READER_IMAGE_FORMAT_GRAYSCALE;
+    if (chosen.color) {
+        switch (image.format) {
+            case ID_READER_IMAGE_FORMAT_RGB:
+            case ID_READER_IMAGE_FORMAT_BGR:
+                channels = 3;
+                break;
+            case ID_READER_IMAGE_FORMAT_RGBA:
+            case ID_READER_IMAGE_FORMAT_BGRA:
+                channels = 4;
+                break;
+            case ID_READER_IMAGE_FORMAT_GRAYSCALE:
+                break;
+            default:
+                return ID_READER_ERROR_UNSUPPORTED_FORMAT;
+        }
+        format = image.format;
+    }
+    
+    // The crop size is known before any pixels are touched, so an undersized
+    // buffer is reported without doing the warp
+    cv::Size image_size(static_cast<int>(image.width), static_cast<int>(image.height));
+    settings.format = id_reader::preprocessing::DocumentRectifier::resolveFormat(settings.format, bounds, image_size);
+    cv::Size size = id_reader::preprocessing::rectifiedSize(settings.format, settings.dpi);
+    size_t stride = static_cast<size_t>(size.width) * channels;
+    size_t required = stride * size.height;
+    
+    *output = id_reader_image_t();
+    output->width = size.width;
+    output->height = size.height;
+    output->stride = stride;
+    output->format = format;
+    
+    cv::Mat caller_pixels;
+    if (buffer) {
+        buffer->required_capacity = required;
+        if (!buffer->data || buffer->capacity < required) {
+            return ID_READER_ERROR_BUFFER_TOO_SMALL;
+        }
+        caller_pixels = cv::Mat(size, CV_8UC(channels), buffer->data, stride);
+    }
+    
+    cv::Mat& target = buffer ? caller_pixels : session.rectified();
+    id_reader_error_t error = session.rectify(image, bounds, settings, chosen.color, target);
+    if (error != ID_READER_SUCCESS) {
+        return error;
+    }
+    
+    output->data = target.data;
+    return ID_READER_SUCCESS;
+}
+
+void copyQuality(const id_reader::preprocessing::QualityReport& report, id_reader_quality_t* quality) {
+    quality->score = report.score;
+    quality->reasons = report.reasons;
+    quality->sharpness = static_cast<float>(report.sharpness);
+    quality->glare_ratio = static_cast<float>(report.glare_ratio);
+    quality->brightness = static_cast<float>(report.brightness);
+}
+
+id_reader_error_t assessQuality(Session& session, const id_reader_image_t& image, id_reader_quality_t* quality) {
+    id_reader::preprocessing::QualityReport report;
+    id_reader_error_t error = session.assessQuality(image, report);
+    if (error != ID_READER_SUCCESS) {
+        return error;
+    }
+    
+    copyQuality(report, quality);
+    return ID_READER_SUCCESS;
+}
+
+id_reader::core::AsyncProcessor& asyncProcessor(id_reader_context* context) {
+    if (!context->async) {
+        const id_reader::core::EngineSettings& settings = currentEngine(context)->settings();
+        context->async = std::make_unique<id_reader::core::AsyncProcessor>(
+            settings.async_threads, settings.async_extract_threads, settings.async_max_pending,
+            settings.async_queue_policy);
+    }
+    return *context->async;
+}
+
+id_reader_error_t copyStats(const Session& session, id_reader_stats_t* stats) {
+    if (!session.collectsStats()) {
+        return ID_READER_ERROR_NOT_ENABLED;
+    }
+    
+    const id_reader::core::StageTimings& timings = session.timings();
+    stats->ingest_ms = timings.ingest_ms;
+    stats->quality_ms = timings.quality_ms;
+    stats->preprocess_ms = timings.preprocess_ms;
+    stats->contours_ms = timings.contours_ms;
+    stats->quad_selection_ms = timings.quad_selection_ms;
+    stats->bounds_ms = timings.bounds_ms;
+    stats->confidence_ms = timings.confidence_ms;
+    stats->rectify_ms = timings.rectify_ms;
+    stats->mrz_ms = timings.mrz_ms;
+    stats->barcode_ms = timings.barcode_ms;
+    stats->classify_ms = timings.classify_ms;
+    stats->total_ms = timings.total_ms;
+    return ID_READER_SUCCESS;
+}
+
+} // namespace
+
 extern "C" {
 
 const char* id_reader_version_string(void) {
@@ -58,6 +407,14 @@ const char* id_reader_error_string(id_reader_error_t error) {
             return "Unsupported format";
         case ID_READER_ERROR_INITIALIZATION_FAILED:
             return "Initialization failed";
+        case ID_READER_ERROR_BUFFER_TOO_SMALL:
+            return "Buffer too small";
+        case ID_READER_ERROR_NOT_ENABLED:
+            return "Feature not enabled";
+        case ID_READER_ERROR_LOW_QUALITY:
+            return "Image quality too low";
+        case ID_READER_ERROR_CANCELLED:
+            return "Request cancelled";
         default:
             return "Unknown error";
     }
@@ -100,12 +457,24 @@ const char* id_reader_country_string(id_reader_country_t country) {
 }
 
 id_reader_error_t id_reader_init(id_reader_context_t** context) {
+    return id_reader_init_with_bundle(context, nullptr);
+}
+
+id_reader_error_t id_reader_init_with_bundle(id_reader_context_t** context, const char* bundle_path) {
     if (!context) {
         return ID_READER_ERROR_INVALID_INPUT;
     }
     
     try {
-        *context = new id_reader_context();
+        std::unique_ptr<id_reader_context> created(new id_reader_context());
+        if (bundle_path) {
+            // Maps the file and checks its index; assets are decoded on first use
+            created->bundle = id_reader::core::AssetBundle::open(bundle_path);
+            if (!created->bundle) {
+                return ID_READER_ERROR_INITIALIZATION_FAILED;
+            }
+        }
+        *context = created.release();
         return ID_READER_SUCCESS;
     } catch (const std::exception&) {
         return ID_READER_ERROR_MEMORY_ALLOCATION;
@@ -122,21 +491,19 @@ id_reader_error_t id_reader_set_config(id_reader_context_t* context, const char*
     }
     
     try {
-        context->config[key] = value;
+        // Reject values the engine could not parse before accepting them
+        id_reader::core::ConfigMap updated = context->config;
+        updated[key] = value;
+        id_reader::core::parseEngineSettings(updated);
+        context->config.swap(updated);
         
-        // Apply configuration to detector if relevant
-        if (std::string(key) == "canny_threshold1") {
-            double threshold = std::stod(value);
-            context->detector->setCannyThresholds(threshold, 150); // Keep default for threshold2
-        } else if (std::string(key) == "canny_threshold2") {
-            double threshold = std::stod(value);
-            context->detector->setCannyThresholds(50, threshold); // Keep default for threshold1
-        } else if (std::string(key) == "min_contour_area") {
-            double area = std::stod(value);
-            context->detector->setContourAreaRange(area, 500000); // Keep default for max
-        } else if (std::string(key) == "max_contour_area") {
-            double area = std::stod(value);
-            context->detector->setContourAreaRange(10000, area); // Keep default for min
+        // Existing engines are immutable; the next call builds a new one
+        context->engine.reset();
+        if (std::string(key) == "batch_threads") {
+            context->batch_pool.reset();
+        }
+        if (std::string(key).compare(0, 6, "async_") == 0) {
+            context->async.reset();
         }
         
         return ID_READER_SUCCESS;
@@ -174,68 +541,472 @@ id_reader_error_t id_reader_process_image(
     }
     
     try {
-        // Convert input image to OpenCV Mat
-        cv::Mat cv_image;
-        int cv_type;
+        currentEngine(context);
+        return processImage(*context->session, *image, result);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_process_image_into(
+    id_reader_context_t* context,
+    const id_reader_image_t* image,
+    id_reader_result_t* result,
+    id_reader_result_buffer_t* buffer) {
+    
+    if (!context || !image || !result || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        currentEngine(context);
+        return processImageInto(*context->session, *image, result, buffer);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_process_batch(
+    id_reader_context_t* context,
+    const id_reader_image_t* images,
+    size_t count,
+    id_reader_result_t** results,
+    id_reader_error_t* errors) {
+    
+    if (!context || !images || !results) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        prepareBatchWorkers(context);
         
-        switch (image->format) {
-            case ID_READER_IMAGE_FORMAT_RGB:
-                cv_type = CV_8UC3;
-                cv_image = cv::Mat(image->height, image->width, cv_type, image->data, image->stride);
-                cv::cvtColor(cv_image, cv_image, cv::COLOR_RGB2BGR);
-                break;
-            case ID_READER_IMAGE_FORMAT_RGBA:
-                cv_type = CV_8UC4;
-                cv_image = cv::Mat(image->height, image->width, cv_type, image->data, image->stride);
-                cv::cvtColor(cv_image, cv_image, cv::COLOR_RGBA2BGR);
-                break;
-            case ID_READER_IMAGE_FORMAT_BGR:
-                cv_type = CV_8UC3;
-                cv_image = cv::Mat(image->height, image->width, cv_type, image->data, image->stride);
-                break;
-            case ID_READER_IMAGE_FORMAT_BGRA:
-                cv_type = CV_8UC4;
-                cv_image = cv::Mat(image->height, image->width, cv_type, image->data, image->stride);
-                cv::cvtColor(cv_image, cv_image, cv::COLOR_BGRA2BGR);
-                break;
-            case ID_READER_IMAGE_FORMAT_GRAYSCALE:
-                cv_type = CV_8UC1;
-                cv_image = cv::Mat(image->height, image->width, cv_type, image->data, image->stride);
-                break;
-            default:
-                return ID_READER_ERROR_UNSUPPORTED_FORMAT;
+        // Each index writes only its own output slots, so results come back
+        // in input order without any synchronization
+        context->batch_pool->parallelFor(count, [context, images, results, errors](size_t i, size_t worker) {
+            results[i] = nullptr;
+            id_reader_error_t error;
+            try {
+                error = processImage(*context->batch_sessions[worker], images[i], &results[i]);
+            } catch (const std::exception&) {
+                error = ID_READER_ERROR_PROCESSING_FAILED;
+            }
+            if (errors) {
+                errors[i] = error;
+            }
+        });
+        
+        return ID_READER_SUCCESS;
+        
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_process_image_async(
+    id_reader_context_t* context,
+    const id_reader_image_t* image,
+    id_reader_completion_callback_t callback,
+    void* user_data,
+    id_reader_async_request_t** request) {
+    
+    if (!context || !image || !callback || !image->data || image->width == 0 || image->height == 0) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        auto async_request = std::make_shared<id_reader::core::AsyncRequest>();
+        async_request->engine = currentEngine(context);
+        
+        // Grayscale and YUV input is wrapped rather than converted, so take a
+        // private copy the worker can read after the caller moves on
+        if (!id_reader::preprocessing::ingestLuma(*image, async_request->luma)) {
+            return ID_READER_ERROR_UNSUPPORTED_FORMAT;
         }
+        if (async_request->luma.data == image->data) {
+            async_request->luma = async_request->luma.clone();
+        }
+        
+        async_request->completion = [callback, user_data](id_reader_error_t error, const ProcessingOutput* output) {
+            id_reader_result_t* result = nullptr;
+            if (output) {
+                try {
+                    result = createResult(*output);
+                } catch (const std::bad_alloc&) {
+                    error = ID_READER_ERROR_MEMORY_ALLOCATION;
+                }
+            }
+            callback(error, result, user_data);
+        };
+        
+        std::unique_ptr<id_reader_async_request> handle;
+        if (request) {
+            handle.reset(new id_reader_async_request{async_request});
+        }
+        
+        asyncProcessor(context).submit(std::move(async_request));
+        if (request) {
+            *request = handle.release();
+        }
+        return ID_READER_SUCCESS;
         
-        // Detect document bounds
-        id_reader::preprocessing::DocumentBounds bounds;
-        if (!context->detector->detectDocument(cv_image, bounds)) {
+    } catch (const std::bad_alloc&) {
+        return ID_READER_ERROR_MEMORY_ALLOCATION;
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+void id_reader_async_cancel(id_reader_async_request_t* request) {
+    if (request) {
+        request->request->cancelled = true;
+    }
+}
+
+void id_reader_async_release(id_reader_async_request_t* request) {
+    delete request;
+}
+
+id_reader_error_t id_reader_engine_create(id_reader_context_t* context, id_reader_engine_t** engine) {
+    if (!context || !engine) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        *engine = new id_reader_engine{currentEngine(context)};
+        return ID_READER_SUCCESS;
+    } catch (const std::bad_alloc&) {
+        return ID_READER_ERROR_MEMORY_ALLOCATION;
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+void id_reader_engine_release(id_reader_engine_t* engine) {
+    delete engine;
+}
+
+id_reader_error_t id_reader_session_create(id_reader_engine_t* engine, id_reader_session_t** session) {
+    if (!engine || !session) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        *session = new id_reader_session(engine->engine);
+        return ID_READER_SUCCESS;
+    } catch (const std::bad_alloc&) {
+        return ID_READER_ERROR_MEMORY_ALLOCATION;
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+void id_reader_session_destroy(id_reader_session_t* session) {
+    delete session;
+}
+
+id_reader_error_t id_reader_session_process_image(
+    id_reader_session_t* session,
+    const id_reader_image_t* image,
+    id_reader_result_t** result) {
+    
+    if (!session || !image || !result || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        return processImage(session->session, *image, result);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_session_process_image_into(
+    id_reader_session_t* session,
+    const id_reader_image_t* image,
+    id_reader_result_t* result,
+    id_reader_result_buffer_t* buffer) {
+    
+    if (!session || !image || !result || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        return processImageInto(session->session, *image, result, buffer);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_stream_begin(id_reader_context_t* context, id_reader_stream_t** stream) {
+    if (!context || !stream) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        *stream = new id_reader_stream(currentEngine(context));
+        return ID_READER_SUCCESS;
+    } catch (const std::bad_alloc&) {
+        return ID_READER_ERROR_MEMORY_ALLOCATION;
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_stream_push_frame(
+    id_reader_stream_t* stream,
+    const id_reader_image_t* image,
+    id_reader_result_t** result) {
+    
+    if (!stream || !image || !result || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        Session& session = stream->session;
+        session.timings().reset();
+        ID_READER_TIME_STAGE(session.collectsStats() ? &session.timings() : nullptr, total_ms);
+        
+        // The stream's session keeps its luma buffer, so steady-state frames reuse it
+        id_reader_error_t error = stream->session.ingest(*image);
+        if (error != ID_READER_SUCCESS) {
+            return error;
+        }
+        
+        // Rejected frames leave the tracker's state untouched
+        error = stream->session.checkQuality();
+        if (error != ID_READER_SUCCESS) {
+            return error;
+        }
+        
+        ProcessingOutput output;
+        if (!stream->tracker.trackDocument(stream->session.luma(), output.bounds)) {
             return ID_READER_ERROR_NO_DOCUMENT_FOUND;
         }
+        output.overall_confidence = output.bounds.confidence;
         
-        // Create result structure
-        *result = new id_reader_result_t();
-        (*result)->document_type = ID_READER_DOCUMENT_UNKNOWN; // Will be determined by classification
-        (*result)->country = ID_READER_COUNTRY_UNKNOWN; // Will be determined by classification
-        (*result)->bounds.x1 = bounds.x1;
-        (*result)->bounds.y1 = bounds.y1;
-        (*result)->bounds.x2 = bounds.x2;
-        (*result)->bounds.y2 = bounds.y2;
-        (*result)->bounds.x3 = bounds.x3;
-        (*result)->bounds.y3 = bounds.y3;
-        (*result)->bounds.x4 = bounds.x4;
-        (*result)->bounds.y4 = bounds.y4;
-        (*result)->bounds.confidence = bounds.confidence;
-        (*result)->fields = nullptr;
-        (*result)->field_count = 0;
-        (*result)->overall_confidence = bounds.confidence;
+        *result = createResult(output);
+        return ID_READER_SUCCESS;
         
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+void id_reader_stream_end(id_reader_stream_t* stream) {
+    delete stream;
+}
+
+id_reader_error_t id_reader_rectify_document(
+    id_reader_context_t* context,
+    const id_reader_image_t* image,
+    const id_reader_document_bounds_t* bounds,
+    const id_reader_rectify_options_t* options,
+    id_reader_image_t* output,
+    id_reader_image_buffer_t* buffer) {
+    
+    if (!context || !image || !bounds || !output || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        currentEngine(context);
+        return rectifyDocument(*context->session, *image, *bounds, options, output, buffer);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_session_rectify_document(
+    id_reader_session_t* session,
+    const id_reader_image_t* image,
+    const id_reader_document_bounds_t* bounds,
+    const id_reader_rectify_options_t* options,
+    id_reader_image_t* output,
+    id_reader_image_buffer_t* buffer) {
+    
+    if (!session || !image || !bounds || !output || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        return rectifyDocument(session->session, *image, *bounds, options, output, buffer);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_burst_begin(id_reader_context_t* context, id_reader_burst_t** burst) {
+    if (!context || !burst) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        *burst = new id_reader_burst(currentEngine(context));
         return ID_READER_SUCCESS;
+    } catch (const std::bad_alloc&) {
+        return ID_READER_ERROR_MEMORY_ALLOCATION;
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_INITIALIZATION_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_burst_push_frame(id_reader_burst_t* burst, const id_reader_image_t* image,
+                                             float* frame_score) {
+    if (!burst || !image || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        float score = 0.0f;
+        id_reader_error_t error = burst->selector.pushFrame(*image, score);
+        if (frame_score) {
+            *frame_score = score;
+        }
+        return error;
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_burst_finish(id_reader_burst_t* burst, id_reader_result_t** result) {
+    if (!burst || !result) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        ProcessingOutput output;
+        id_reader_error_t error = burst->selector.finish(output);
+        if (error != ID_READER_SUCCESS) {
+            return error;
+        }
         
+        *result = createResult(output);
+        return ID_READER_SUCCESS;
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_burst_get_best_frame(id_reader_burst_t* burst, id_reader_image_t* frame,
+                                                 id_reader_document_bounds_t* bounds) {
+    if (!burst || !frame) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    const id_reader::core::BurstCandidate* best = burst->selector.best();
+    if (!best) {
+        return ID_READER_ERROR_NO_DOCUMENT_FOUND;
+    }
+    
+    *frame = id_reader_image_t();
+    frame->data = best->luma.data;
+    frame->width = best->luma.cols;
+    frame->height = best->luma.rows;
+    frame->stride = best->luma.step;
+    frame->format = ID_READER_IMAGE_FORMAT_GRAYSCALE;
+    
+    if (bounds) {
+        bounds->x1 = best->bounds.x1;
+        bounds->y1 = best->bounds.y1;
+        bounds->x2 = best->bounds.x2;
+        bounds->y2 = best->bounds.y2;
+        bounds->x3 = best->bounds.x3;
+        bounds->y3 = best->bounds.y3;
+        bounds->x4 = best->bounds.x4;
+        bounds->y4 = best->bounds.y4;
+        bounds->confidence = best->bounds.confidence;
+    }
+    return ID_READER_SUCCESS;
+}
+
+void id_reader_burst_end(id_reader_burst_t* burst) {
+    delete burst;
+}
+
+id_reader_error_t id_reader_assess_quality(id_reader_context_t* context, const id_reader_image_t* image,
+                                           id_reader_quality_t* quality) {
+    if (!context || !image || !quality || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        currentEngine(context);
+        return assessQuality(*context->session, *image, quality);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_session_assess_quality(id_reader_session_t* session, const id_reader_image_t* image,
+                                                   id_reader_quality_t* quality) {
+    if (!session || !image || !quality || !image->data) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        return assessQuality(session->session, *image, quality);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_get_quality(id_reader_context_t* context, id_reader_quality_t* quality) {
+    if (!context || !quality) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        currentEngine(context);
+        copyQuality(context->session->quality(), quality);
+        return ID_READER_SUCCESS;
     } catch (const std::exception&) {
         return ID_READER_ERROR_PROCESSING_FAILED;
     }
 }
 
+id_reader_error_t id_reader_session_get_quality(id_reader_session_t* session, id_reader_quality_t* quality) {
+    if (!session || !quality) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    copyQuality(session->session.quality(), quality);
+    return ID_READER_SUCCESS;
+}
+
+id_reader_error_t id_reader_stream_get_quality(id_reader_stream_t* stream, id_reader_quality_t* quality) {
+    if (!stream || !quality) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    copyQuality(stream->session.quality(), quality);
+    return ID_READER_SUCCESS;
+}
+
+id_reader_error_t id_reader_get_stats(id_reader_context_t* context, id_reader_stats_t* stats) {
+    if (!context || !stats) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    try {
+        currentEngine(context);
+        return copyStats(*context->session, stats);
+    } catch (const std::exception&) {
+        return ID_READER_ERROR_PROCESSING_FAILED;
+    }
+}
+
+id_reader_error_t id_reader_session_get_stats(id_reader_session_t* session, id_reader_stats_t* stats) {
+    if (!session || !stats) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    return copyStats(session->session, stats);
+}
+
+id_reader_error_t id_reader_stream_get_stats(id_reader_stream_t* stream, id_reader_stats_t* stats) {
+    if (!stream || !stats) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    return copyStats(stream->session, stats);
+}
+
 void id_reader_free_result(id_reader_result_t* result) {
     if (!result) {
         return;
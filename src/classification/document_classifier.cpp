@@ -0,0 +1,238 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "document_classifier.h"
+#include <tensorflow/lite/interpreter.h>
+#include <tensorflow/lite/kernels/register.h>
+#include <tensorflow/lite/model.h>
+#include <algorithm>
+#include <cmath>
+
+namespace id_reader {
+namespace classification {
+
+namespace {
+
+constexpr int kDocumentTypeCount = ID_READER_DOCUMENT_CREDIT_CARD + 1;
+constexpr int kCountryCount = ID_READER_COUNTRY_AU + 1;
+
+// Smallest accepted softmax temperature
+constexpr float kMinTemperature = 0.01f;
+
+// The document is rectified at this multiple of the model's input size
+// (about 200 dpi for an ID-1 card into a 224 px wide input), then area
+// averaged down to it
+constexpr int kOversample = 3;
+
+int elementCount(const TfLiteTensor& tensor) {
+    int count = 1;
+    for (int i = 0; i < tensor.dims->size; ++i) {
+        count *= tensor.dims->data[i];
+    }
+    return count;
+}
+
+// OpenCV depth of an input tensor's elements, or -1 when unsupported
+int tensorDepth(TfLiteType type) {
+    switch (type) {
+        case kTfLiteFloat32:
+            return CV_32F;
+        case kTfLiteUInt8:
+            return CV_8U;
+        case kTfLiteInt8:
+            return CV_8S;
+        default:
+            return -1;
+    }
+}
+
+} // namespace
+
+struct ClassifierModel::Impl {
+    std::unique_ptr<tflite::FlatBufferModel> model;
+    tflite::ops::builtin::BuiltinOpResolver resolver;
+};
+
+ClassifierModel::ClassifierModel() : impl_(std::make_unique<Impl>()) {}
+
+ClassifierModel::~ClassifierModel() = default;
+
+std::unique_ptr<ClassifierModel> ClassifierModel::load(const std::string& path) {
+    std::unique_ptr<ClassifierModel> model(new ClassifierModel());
+    // BuildFromFile maps the file rather than reading it into memory
+    model->impl_->model = tflite::FlatBufferModel::BuildFromFile(path.c_str());
+    if (!model->impl_->model) {
+        return nullptr;
+    }
+    return model;
+}
+
+std::unique_ptr<ClassifierModel> ClassifierModel::fromBuffer(const void* data, size_t size) {
+    std::unique_ptr<ClassifierModel> model(new ClassifierModel());
+    model->impl_->model = tflite::FlatBufferModel::BuildFromBuffer(static_cast<const char*>(data), size);
+    if (!model->impl_->model) {
+        return nullptr;
+    }
+    return model;
+}
+
+struct DocumentClassifier::Impl {
+    std::unique_ptr<tflite::Interpreter> interpreter;
+    TfLiteTensor* input = nullptr;
+    int document_type_output = -1;
+    int country_output = -1;
+};
+
+DocumentClassifier::DocumentClassifier(const ClassifierModel& model, const ClassifierSettings& settings)
+    : impl_(std::make_unique<Impl>()), settings_(settings) {
+    settings_.temperature = std::max(kMinTemperature, settings_.temperature);
+    
+    const ClassifierModel::Impl& shared = *model.impl_;
+    if (tflite::InterpreterBuilder(*shared.model, shared.resolver)(&impl_->interpreter) != kTfLiteOk ||
+        !impl_->interpreter) {
+        return;
+    }
+    tflite::Interpreter& interpreter = *impl_->interpreter;
+    interpreter.SetNumThreads(std::max(1, settings_.threads));
+    if (interpreter.inputs().size() != 1 || interpreter.AllocateTensors() != kTfLiteOk) {
+        return;
+    }
+    
+    // Input: [1, height, width, channels], viewed in place as a cv::Mat
+    impl_->input = interpreter.input_tensor(0);
+    const TfLiteTensor& input = *impl_->input;
+    int depth = tensorDepth(input.type);
+    if (depth < 0 || input.dims->size != 4 || input.dims->data[0] != 1 ||
+        (input.dims->data[3] != 1 && input.dims->data[3] != 3)) {
+        return;
+    }
+    input_ = cv::Mat(input.dims->data[1], input.dims->data[2], CV_MAKETYPE(depth, input.dims->data[3]),
+                     input.data.raw);
+    
+    // Outputs are told apart by their class count
+    for (size_t i = 0; i < interpreter.outputs().size(); ++i) {
+        int count = elementCount(*interpreter.output_tensor(i));
+        if (count == kDocumentTypeCount) {
+            impl_->document_type_output = static_cast<int>(i);
+        } else if (count == kCountryCount) {
+            impl_->country_output = static_cast<int>(i);
+        }
+    }
+    logits_.resize(std::max(kDocumentTypeCount, kCountryCount));
+    ready_ = impl_->document_type_output >= 0 || impl_->country_output >= 0;
+}
+
+DocumentClassifier::~DocumentClassifier() = default;
+
+bool DocumentClassifier::classify(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds,
+                                  preprocessing::DocumentRectifier& rectifier, Classification& result) {
+    result = Classification();
+    if (!ready_) {
+        return false;
+    }
+    
+    // Warping a large document straight to the input size would point
+    // sample it and alias, unlike the area-resampled images models are
+    // trained on. The warp stops at a few times the input size and area
+    // averaging takes it the rest of the way, at the cost of one small
+    // intermediate image. A single-channel uint8 input that is unquantized
+    // or quantized from exactly 0-255 takes the result directly; anything
+    // else gets one conversion pass.
+    const TfLiteTensor& input = *impl_->input;
+    preprocessing::RectifySettings settings;
+    settings.size = input_.size() * kOversample;
+    if (!rectifier.rectify(luma, bounds, settings, warped_)) {
+        return false;
+    }
+    bool direct = input.type == kTfLiteUInt8 && input_.channels() == 1 && input.params.zero_point == 0 &&
+                  (input.params.scale == 0.0f || std::abs(input.params.scale * 255.0f - 1.0f) < 1e-3f);
+    // resize writes into input_'s existing buffer, as size and type match
+    cv::resize(warped_, direct ? input_ : crop_, input_.size(), 0, 0, cv::INTER_AREA);
+    if (!direct) {
+        fillInput();
+    }
+    
+    tflite::Interpreter& interpreter = *impl_->interpreter;
+    if (interpreter.Invoke() != kTfLiteOk) {
+        return false;
+    }
+    
+    // Dequantize the logits, then calibrate
+    auto read = [&](int index, int count) {
+        const TfLiteTensor& output = *interpreter.output_tensor(static_cast<size_t>(index));
+        for (int i = 0; i < count; ++i) {
+            switch (output.type) {
+                case kTfLiteFloat32:
+                    logits_[i] = output.data.f[i];
+                    break;
+                case kTfLiteUInt8:
+                    logits_[i] = output.params.scale * (output.data.uint8[i] - output.params.zero_point);
+                    break;
+                case kTfLiteInt8:
+                    logits_[i] = output.params.scale * (output.data.int8[i] - output.params.zero_point);
+                    break;
+                default:
+                    return false;
+            }
+        }
+        return true;
+    };
+    
+    float probability = 0.0f;
+    if (impl_->document_type_output >= 0 && read(impl_->document_type_output, kDocumentTypeCount)) {
+        int index = calibrate(logits_.data(), kDocumentTypeCount, probability);
+        if (index != ID_READER_DOCUMENT_UNKNOWN && probability >= settings_.min_confidence) {
+            result.document_type = static_cast<id_reader_document_type_t>(index);
+            result.document_type_confidence = probability;
+        }
+    }
+    if (impl_->country_output >= 0 && read(impl_->country_output, kCountryCount)) {
+        int index = calibrate(logits_.data(), kCountryCount, probability);
+        if (index != ID_READER_COUNTRY_UNKNOWN && probability >= settings_.min_confidence) {
+            result.country = static_cast<id_reader_country_t>(index);
+            result.country_confidence = probability;
+        }
+    }
+    return true;
+}
+
+void DocumentClassifier::fillInput() {
+    const cv::Mat* source = &crop_;
+    if (input_.channels() == 3) {
+        cv::cvtColor(crop_, color_, cv::COLOR_GRAY2RGB);
+        source = &color_;
+    }
+    
+    // Pixels map to 0-1; quantized tensors store value / scale + zero point
+    const TfLiteTensor& input = *impl_->input;
+    double alpha = 1.0 / 255.0;
+    double beta = 0.0;
+    if (input.type != kTfLiteFloat32 && input.params.scale > 0.0f) {
+        alpha /= input.params.scale;
+        beta = input.params.zero_point;
+    } else if (input.type != kTfLiteFloat32) {
+        alpha = 1.0;
+    }
+    // convertTo writes into input_'s existing buffer, as size and type match
+    source->convertTo(input_, input_.type(), alpha, beta);
+}
+
+int DocumentClassifier::calibrate(const float* logits, int count, float& probability) {
+    int best = static_cast<int>(std::max_element(logits, logits + count) - logits);
+    double sum = 0.0;
+    for (int i = 0; i < count; ++i) {
+        sum += std::exp((logits[i] - logits[best]) / settings_.temperature);
+    }
+    probability = static_cast<float>(1.0 / sum);
+    return best;
+}
+
+} // namespace classification
+} // namespace id_reader
@@ -0,0 +1,116 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_DOCUMENT_CLASSIFIER_H
+#define ID_READER_DOCUMENT_CLASSIFIER_H
+
+#include "id_reader/id_reader.h"
+#include "../preprocessing/rectification/document_rectifier.h"
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace id_reader {
+namespace classification {
+
+struct ClassifierSettings {
+    bool enabled = true;
+    std::string model_path;       // TensorFlow Lite model; empty: documents stay unclassified
+    float temperature = 1.0f;     // Softmax temperature fitted on held-out data, so confidences are calibrated
+    float min_confidence = 0.5f;  // Predictions below this are reported as unknown
+    int threads = 1;              // Interpreter threads per worker
+};
+
+// Document type and country of one document, each with its calibrated
+// probability (0 when unknown)
+struct Classification {
+    id_reader_document_type_t document_type = ID_READER_DOCUMENT_UNKNOWN;
+    float document_type_confidence = 0.0f;
+    id_reader_country_t country = ID_READER_COUNTRY_UNKNOWN;
+    float country_confidence = 0.0f;
+};
+
+// A TensorFlow Lite classification model, memory-mapped from its flatbuffer
+// once per engine and shared read-only by every session's interpreter.
+//
+// The model takes one [1, height, width, channels] image (1 or 3 channels)
+// of the rectified document: float32 scaled to 0-1, or uint8/int8 quantized
+// from that range. It has one output of 5 logits in id_reader_document_type_t
+// order and/or one of 7 logits in id_reader_country_t order.
+class ClassifierModel {
+public:
+    ~ClassifierModel();
+    
+    ClassifierModel(const ClassifierModel&) = delete;
+    ClassifierModel& operator=(const ClassifierModel&) = delete;
+    
+    // nullptr when the file cannot be mapped or is not a model
+    static std::unique_ptr<ClassifierModel> load(const std::string& path);
+    
+    // Use a flatbuffer already in memory, such as an asset bundle section.
+    // It is read in place and must outlive the model.
+    static std::unique_ptr<ClassifierModel> fromBuffer(const void* data, size_t size);
+    
+private:
+    friend class DocumentClassifier;
+    struct Impl;
+    
+    ClassifierModel();
+    
+    std::unique_ptr<Impl> impl_;
+};
+
+// One interpreter over a shared model. Its tensors are allocated once at
+// construction; the document is rectified at a few times the model's input
+// size and area averaged down into the input tensor through buffers kept
+// between calls, so classifying a document allocates nothing once warm.
+// Not thread-safe: one per session.
+class DocumentClassifier {
+public:
+    DocumentClassifier(const ClassifierModel& model, const ClassifierSettings& settings);
+    ~DocumentClassifier();
+    
+    DocumentClassifier(const DocumentClassifier&) = delete;
+    DocumentClassifier& operator=(const DocumentClassifier&) = delete;
+    
+    // False when the interpreter could not be built or the model's inputs
+    // and outputs do not follow the layout above
+    bool ready() const { return ready_; }
+    
+    // Rectify `bounds` of `luma` into the input tensor, run the model and
+    // turn its logits into calibrated probabilities
+    bool classify(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds,
+                  preprocessing::DocumentRectifier& rectifier, Classification& result);
+    
+private:
+    struct Impl;
+    
+    // Write crop_ into the input tensor, converting type and channels
+    void fillInput();
+    
+    // Softmax of `logits` / temperature; index and probability of the top class
+    int calibrate(const float* logits, int count, float& probability);
+    
+    std::unique_ptr<Impl> impl_;
+    ClassifierSettings settings_;
+    bool ready_ = false;
+    cv::Mat input_;     // Header over the input tensor's memory
+    cv::Mat warped_;    // Rectified document at a multiple of the input size
+    cv::Mat crop_;      // Crop at the input size, when the tensor cannot take it as is
+    cv::Mat color_;     // Crop replicated to three channels
+    std::vector<float> logits_;
+};
+
+} // namespace classification
+} // namespace id_reader
+
+#endif // ID_READER_DOCUMENT_CLASSIFIER_H
@@ -0,0 +1,204 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "asset_bundle.h"
+#include <cstring>
+#include <fstream>
+#include <map>
+
+namespace id_reader {
+namespace core {
+
+namespace {
+
+uint64_t alignUp(uint64_t offset) {
+    return (offset + kAssetSectionAlignment - 1) / kAssetSectionAlignment * kAssetSectionAlignment;
+}
+
+// How well one key of a section fits a request: the same value, a section
+// for any value, or (for an unknown request) a section for some value.
+// -1 when the section is for a different value.
+int keyScore(uint32_t entry, uint32_t requested) {
+    if (entry != 0 && entry == requested) {
+        return 2;
+    }
+    if (entry == 0) {
+        return 1;
+    }
+    return requested == 0 ? 0 : -1;
+}
+
+// How specific a section is for a request, or -1 when it does not apply.
+// The document type outweighs the country.
+int matchScore(const AssetSectionEntry& entry, AssetKind kind, id_reader_document_type_t type,
+               id_reader_country_t country) {
+    if (entry.kind != static_cast<uint32_t>(kind)) {
+        return -1;
+    }
+    int type_score = keyScore(entry.document_type, static_cast<uint32_t>(type));
+    int country_score = keyScore(entry.country, static_cast<uint32_t>(country));
+    if (type_score < 0 || country_score < 0) {
+        return -1;
+    }
+    return type_score * 3 + country_score;
+}
+
+} // namespace
+
+bool writeAssetBundle(const std::string& path, const std::vector<AssetBundleEntry>& entries) {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+    
+    // Sections first, each aligned, then the index
+    std::vector<AssetSectionEntry> index;
+    uint64_t offset = sizeof(AssetBundleHeader);
+    const char padding[kAssetSectionAlignment] = {};
+    file.write(padding, sizeof(AssetBundleHeader));
+    for (const AssetBundleEntry& entry : entries) {
+        uint64_t start = alignUp(offset);
+        file.write(padding, static_cast<std::streamsize>(start - offset));
+        file.write(reinterpret_cast<const char*>(entry.data.data()), static_cast<std::streamsize>(entry.data.size()));
+        
+        AssetSectionEntry section = {};
+        section.kind = static_cast<uint32_t>(entry.kind);
+        section.document_type = static_cast<uint32_t>(entry.document_type);
+        section.country = static_cast<uint32_t>(entry.country);
+        section.offset = start;
+        section.size = entry.data.size();
+        index.push_back(section);
+        offset = start + entry.data.size();
+    }
+    
+    AssetBundleHeader header = {};
+    std::memcpy(header.magic, kAssetBundleMagic, sizeof(header.magic));
+    header.version = kAssetBundleVersion;
+    header.section_count = static_cast<uint32_t>(index.size());
+    header.index_offset = alignUp(offset);
+    header.file_size = header.index_offset + index.size() * sizeof(AssetSectionEntry);
+    file.write(padding, static_cast<std::streamsize>(header.index_offset - offset));
+    file.write(reinterpret_cast<const char*>(index.data()),
+               static_cast<std::streamsize>(index.size() * sizeof(AssetSectionEntry)));
+    file.seekp(0);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    return static_cast<bool>(file);
+}
+
+std::shared_ptr<const AssetBundle> AssetBundle::open(const std::string& path) {
+    static std::mutex mutex;
+    static std::map<std::string, std::weak_ptr<const AssetBundle>> open_bundles;
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    std::shared_ptr<const AssetBundle> bundle = open_bundles[path].lock();
+    if (bundle) {
+        return bundle;
+    }
+    std::shared_ptr<AssetBundle> opened(new AssetBundle());
+    if (!opened->map(path)) {
+        open_bundles.erase(path);
+        return nullptr;
+    }
+    open_bundles[path] = opened;
+    return opened;
+}
+
+bool AssetBundle::map(const std::string& path) {
+    if (!file_.open(path) || file_.size() < sizeof(AssetBundleHeader)) {
+        return false;
+    }
+    
+    // Only the header and the index are touched here
+    const uint64_t size = file_.size();
+    const AssetBundleHeader* header = reinterpret_cast<const AssetBundleHeader*>(file_.data());
+    if (std::memcmp(header->magic, kAssetBundleMagic, sizeof(header->magic)) != 0 ||
+        header->version != kAssetBundleVersion || header->file_size != size ||
+        header->index_offset % alignof(AssetSectionEntry) != 0 || header->index_offset > size ||
+        header->section_count > (size - header->index_offset) / sizeof(AssetSectionEntry)) {
+        return false;
+    }
+    const AssetSectionEntry* sections = reinterpret_cast<const AssetSectionEntry*>(file_.data() + header->index_offset);
+    for (uint32_t i = 0; i < header->section_count; ++i) {
+        if (sections[i].offset % kAssetSectionAlignment != 0 || sections[i].offset > size ||
+            sections[i].size > size - sections[i].offset) {
+            return false;
+        }
+    }
+    
+    header_ = header;
+    sections_ = sections;
+    decode_once_.reset(new std::once_flag[header->section_count]);
+    decoded_.resize(header->section_count);
+    return true;
+}
+
+int AssetBundle::find(AssetKind kind, id_reader_document_type_t type, id_reader_country_t country) const {
+    int best = -1;
+    int best_score = -1;
+    for (uint32_t i = 0; i < header_->section_count; ++i) {
+        int score = matchScore(sections_[i], kind, type, country);
+        if (score > best_score) {
+            best = static_cast<int>(i);
+            best_score = score;
+        }
+    }
+    return best;
+}
+
+const void* AssetBundle::decoded(int index, const Decoder& decode) const {
+    if (index < 0) {
+        return nullptr;
+    }
+    const AssetSectionEntry& section = sections_[index];
+    std::call_once(decode_once_[index], [&] {
+        decoded_[index] = decode(file_.data() + section.offset, static_cast<size_t>(section.size));
+    });
+    return decoded_[index].get();
+}
+
+const classification::ClassifierModel* AssetBundle::classifierModel(id_reader_document_type_t type,
+                                                                    id_reader_country_t country) const {
+    int index = find(AssetKind::ClassifierModel, type, country);
+    return static_cast<const classification::ClassifierModel*>(decoded(index, [](const uint8_t* data, size_t size) {
+        return std::shared_ptr<void>(classification::ClassifierModel::fromBuffer(data, size));
+    }));
+}
+
+const extraction::MrzTemplates* AssetBundle::mrzTemplates(id_reader_document_type_t type,
+                                                          id_reader_country_t country) const {
+    int index = find(AssetKind::MrzTemplates, type, country);
+    return static_cast<const extraction::MrzTemplates*>(decoded(index, [](const uint8_t* data, size_t size) {
+        // Used in place: the matrix header points into the read-only mapping
+        const size_t row_bytes = extraction::kMrzAlphabetSize * sizeof(float);
+        auto templates = std::make_shared<extraction::MrzTemplates>();
+        if (size == 0 || size % row_bytes != 0 ||
+            !templates->loadMatrix(cv::Mat(extraction::kMrzAlphabetSize, static_cast<int>(size / row_bytes), CV_32F,
+                                           const_cast<uint8_t*>(data)))) {
+            return std::shared_ptr<void>();
+        }
+        return std::shared_ptr<void>(templates);
+    }));
+}
+
+const extraction::Pdf417Codebook* AssetBundle::pdf417Codebook(id_reader_document_type_t type,
+                                                              id_reader_country_t country) const {
+    int index = find(AssetKind::Pdf417Codebook, type, country);
+    return static_cast<const extraction::Pdf417Codebook*>(decoded(index, [](const uint8_t* data, size_t size) {
+        auto codebook = std::make_shared<extraction::Pdf417Codebook>();
+        if (size % sizeof(uint32_t) != 0 ||
+            !codebook->loadPatterns(reinterpret_cast<const uint32_t*>(data), size / sizeof(uint32_t))) {
+            return std::shared_ptr<void>();
+        }
+        return std::shared_ptr<void>(codebook);
+    }));
+}
+
+} // namespace core
+} // namespace id_reader
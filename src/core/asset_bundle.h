@@ -0,0 +1,133 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_ASSET_BUNDLE_H
+#define ID_READER_ASSET_BUNDLE_H
+
+#include "id_reader/id_reader.h"
+#include "mapped_file.h"
+#include "../classification/document_classifier.h"
+#include "../extraction/barcode/pdf417_reader.h"
+#include "../extraction/mrz/mrz_reader.h"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace id_reader {
+namespace core {
+
+// What a bundle section holds
+enum class AssetKind : uint32_t {
+    ClassifierModel = 1,  // TensorFlow Lite flatbuffer, as written by the converter
+    MrzTemplates = 2,     // float32 glyph templates: kMrzAlphabetSize rows, row-major (MrzTemplates::templates())
+    Pdf417Codebook = 3    // uint32 codeword patterns: clusters 0, 3 and 6, 929 each
+};
+
+constexpr char kAssetBundleMagic[8] = {'I', 'D', 'R', 'B', 'N', 'D', 'L', '\0'};
+constexpr uint32_t kAssetBundleVersion = 1;
+
+// Section data starts on this boundary, so any payload can be used in place
+constexpr uint64_t kAssetSectionAlignment = 64;
+
+// File layout, little-endian: this header, the section data, then the index
+// of AssetSectionEntry records at index_offset
+struct AssetBundleHeader {
+    char magic[8];
+    uint32_t version;        // Readers reject versions they do not know
+    uint32_t section_count;
+    uint64_t index_offset;
+    uint64_t file_size;      // Catches truncated files
+};
+
+struct AssetSectionEntry {
+    uint32_t kind;           // AssetKind
+    uint32_t document_type;  // id_reader_document_type_t; 0 = any
+    uint32_t country;        // id_reader_country_t; 0 = any
+    uint32_t reserved;
+    uint64_t offset;         // From the start of the file
+    uint64_t size;
+};
+
+static_assert(sizeof(AssetBundleHeader) == 32, "bundle header layout");
+static_assert(sizeof(AssetSectionEntry) == 32, "bundle index layout");
+
+// One section to write
+struct AssetBundleEntry {
+    AssetKind kind;
+    id_reader_document_type_t document_type = ID_READER_DOCUMENT_UNKNOWN;
+    id_reader_country_t country = ID_READER_COUNTRY_UNKNOWN;
+    std::vector<uint8_t> data;
+};
+
+bool writeAssetBundle(const std::string& path, const std::vector<AssetBundleEntry>& entries);
+
+// A memory-mapped asset bundle. Opening one maps the file and checks the
+// header and index; no section is read, so it costs the same however many
+// countries the bundle covers. Each asset is decoded on first use (models
+// and templates are used in place in the mapping, only lookup tables are
+// built) and then shared by every engine holding the bundle.
+class AssetBundle {
+public:
+    // nullptr when the file cannot be mapped or is not a bundle of a known
+    // version. Opening a path that is already open returns the same bundle,
+    // so contexts in one process share its mapping and decoded assets.
+    static std::shared_ptr<const AssetBundle> open(const std::string& path);
+    
+    AssetBundle(const AssetBundle&) = delete;
+    AssetBundle& operator=(const AssetBundle&) = delete;
+    
+    uint32_t version() const { return header_->version; }
+    size_t sectionCount() const { return header_->section_count; }
+    const AssetSectionEntry& section(size_t index) const { return sections_[index]; }
+    
+    // The section of `kind` closest to a document type and country: exact
+    // match first, then one for the type in any country, then one for the
+    // country and any type, then one for anything. An unknown type or country
+    // (before classification) also accepts sections for a specific one, after
+    // the generic ones. -1 when none applies.
+    int find(AssetKind kind, id_reader_document_type_t type, id_reader_country_t country) const;
+    
+    // Decoded assets for a document type and country, or nullptr when the
+    // bundle has no usable section for them
+    const classification::ClassifierModel* classifierModel(
+        id_reader_document_type_t type = ID_READER_DOCUMENT_UNKNOWN,
+        id_reader_country_t country = ID_READER_COUNTRY_UNKNOWN) const;
+    const extraction::MrzTemplates* mrzTemplates(
+        id_reader_document_type_t type = ID_READER_DOCUMENT_UNKNOWN,
+        id_reader_country_t country = ID_READER_COUNTRY_UNKNOWN) const;
+    const extraction::Pdf417Codebook* pdf417Codebook(
+        id_reader_document_type_t type = ID_READER_DOCUMENT_UNKNOWN,
+        id_reader_country_t country = ID_READER_COUNTRY_UNKNOWN) const;
+    
+private:
+    using Decoder = std::function<std::shared_ptr<void>(const uint8_t* data, size_t size)>;
+    
+    AssetBundle() = default;
+    
+    bool map(const std::string& path);
+    
+    // Section `index` decoded by `decode`, which runs at most once per section
+    const void* decoded(int index, const Decoder& decode) const;
+    
+    MappedFile file_;
+    const AssetBundleHeader* header_ = nullptr;
+    const AssetSectionEntry* sections_ = nullptr;
+    std::unique_ptr<std::once_flag[]> decode_once_;
+    mutable std::vector<std::shared_ptr<void>> decoded_;  // Per section; written once under decode_once_
+};
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_ASSET_BUNDLE_H
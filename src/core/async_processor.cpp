@@ -0,0 +1,113 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "async_processor.h"
+#include <algorithm>
+#include <exception>
+#include <new>
+#include <thread>
+
+namespace id_reader {
+namespace core {
+
+namespace {
+
+// Sessions are tied to the engine they were created from
+Session& sessionFor(std::unique_ptr<Session>& session, const std::shared_ptr<const Engine>& engine) {
+    if (!session || session->engine() != engine) {
+        session = std::make_unique<Session>(engine);
+    }
+    return *session;
+}
+
+} // namespace
+
+AsyncProcessor::AsyncProcessor(size_t detect_threads, size_t extract_threads, size_t max_pending,
+                               QueuePolicy policy) {
+    if (detect_threads == 0) {
+        detect_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    extract_threads = std::max<size_t>(1, extract_threads);
+    detect_sessions_.resize(detect_threads);
+    extract_sessions_.resize(extract_threads);
+    
+    std::vector<Pipeline::StageConfig> stages = {
+        {detect_threads, [this](std::shared_ptr<AsyncRequest>& request, size_t worker) {
+            return detect(*request, worker);
+        }},
+        {extract_threads, [this](std::shared_ptr<AsyncRequest>& request, size_t worker) {
+            return extract(*request, worker);
+        }}
+    };
+    pipeline_ = std::make_unique<Pipeline>(stages, max_pending, policy, [](std::shared_ptr<AsyncRequest>& request) {
+        request->completion(ID_READER_ERROR_CANCELLED, nullptr);
+    });
+}
+
+AsyncProcessor::~AsyncProcessor() {
+    pipeline_.reset();
+}
+
+void AsyncProcessor::submit(std::shared_ptr<AsyncRequest> request) {
+    pipeline_->submit(std::move(request));
+}
+
+bool AsyncProcessor::detect(AsyncRequest& request, size_t worker) {
+    if (request.cancelled) {
+        request.completion(ID_READER_ERROR_CANCELLED, nullptr);
+        return false;
+    }
+    
+    id_reader_error_t error;
+    try {
+        Session& session = sessionFor(detect_sessions_[worker], request.engine);
+        id_reader_image_t image = {};
+        image.data = request.luma.data;
+        image.width = request.luma.cols;
+        image.height = request.luma.rows;
+        image.stride = request.luma.step;
+        image.format = ID_READER_IMAGE_FORMAT_GRAYSCALE;
+        error = session.detectDocument(image, request.output.bounds);
+    } catch (const std::bad_alloc&) {
+        error = ID_READER_ERROR_MEMORY_ALLOCATION;
+    } catch (const std::exception&) {
+        error = ID_READER_ERROR_PROCESSING_FAILED;
+    }
+    
+    if (error != ID_READER_SUCCESS) {
+        request.completion(request.cancelled ? ID_READER_ERROR_CANCELLED : error, nullptr);
+        return false;
+    }
+    return true;
+}
+
+bool AsyncProcessor::extract(AsyncRequest& request, size_t worker) {
+    id_reader_error_t error = ID_READER_ERROR_CANCELLED;
+    if (!request.cancelled) {
+        try {
+            Session& session = sessionFor(extract_sessions_[worker], request.engine);
+            error = session.extractDocument(request.luma, request.output.bounds, request.output);
+        } catch (const std::bad_alloc&) {
+            error = ID_READER_ERROR_MEMORY_ALLOCATION;
+        } catch (const std::exception&) {
+            error = ID_READER_ERROR_PROCESSING_FAILED;
+        }
+    }
+    
+    // A request cancelled while running has its result discarded
+    if (request.cancelled) {
+        error = ID_READER_ERROR_CANCELLED;
+    }
+    request.completion(error, error == ID_READER_SUCCESS ? &request.output : nullptr);
+    return false;
+}
+
+} // namespace core
+} // namespace id_reader
@@ -0,0 +1,76 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_ASYNC_PROCESSOR_H
+#define ID_READER_ASYNC_PROCESSOR_H
+
+#include "id_reader/id_reader.h"
+#include "engine.h"
+#include "pipeline_executor.h"
+#include "session.h"
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace id_reader {
+namespace core {
+
+// One queued image. The luma plane is copied at submission, so the caller's
+// buffer may be reused as soon as the submitting call returns.
+struct AsyncRequest {
+    // Runs exactly once; output is null unless error is ID_READER_SUCCESS
+    using Completion = std::function<void(id_reader_error_t error, const ProcessingOutput* output)>;
+    
+    std::shared_ptr<const Engine> engine;  // Configuration at submission
+    cv::Mat luma;
+    Completion completion;
+    std::atomic<bool> cancelled{false};
+    ProcessingOutput output;  // Filled in stage by stage
+};
+
+// Runs process-image requests through a two-stage pipeline: detection
+// workers feed extraction workers (classification, field extraction, result
+// building) through a bounded lock-free queue, so one image can be detected
+// while an earlier one is still being extracted. Each worker owns a session.
+// When max_pending requests already wait for detection, the queue policy
+// decides between blocking the submitter and dropping a request; dropped and
+// cancelled requests complete with ID_READER_ERROR_CANCELLED.
+class AsyncProcessor {
+public:
+    // A detection thread count of 0 uses the number of hardware threads
+    AsyncProcessor(size_t detect_threads, size_t extract_threads, size_t max_pending, QueuePolicy policy);
+    
+    // Requests still queued complete as cancelled; running ones finish their
+    // current stage first
+    ~AsyncProcessor();
+    
+    AsyncProcessor(const AsyncProcessor&) = delete;
+    AsyncProcessor& operator=(const AsyncProcessor&) = delete;
+    
+    void submit(std::shared_ptr<AsyncRequest> request);
+    
+private:
+    using Pipeline = PipelineExecutor<std::shared_ptr<AsyncRequest>>;
+    
+    bool detect(AsyncRequest& request, size_t worker);
+    bool extract(AsyncRequest& request, size_t worker);
+    
+    // Sessions are indexed by worker and touched only by that worker
+    std::vector<std::unique_ptr<Session>> detect_sessions_;
+    std::vector<std::unique_ptr<Session>> extract_sessions_;
+    std::unique_ptr<Pipeline> pipeline_;  // Last, so workers are joined before the sessions go away
+};
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_ASYNC_PROCESSOR_H
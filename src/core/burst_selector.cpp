@@ -0,0 +1,146 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "burst_selector.h"
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace id_reader {
+namespace core {
+
+namespace {
+
+constexpr float kSharpnessWeight = 0.4f;
+constexpr float kConfidenceWeight = 0.4f;
+constexpr float kStabilityWeight = 0.2f;
+
+// Mean corner movement, in normalized image units, at which the stability
+// term drops to one half
+constexpr double kStabilityScale = 0.01;
+
+double meanCornerMovement(const preprocessing::DocumentBounds& a, const preprocessing::DocumentBounds& b) {
+    return (std::hypot(a.x1 - b.x1, a.y1 - b.y1) + std::hypot(a.x2 - b.x2, a.y2 - b.y2) +
+            std::hypot(a.x3 - b.x3, a.y3 - b.y3) + std::hypot(a.x4 - b.x4, a.y4 - b.y4)) / 4.0;
+}
+
+} // namespace
+
+BurstSelector::BurstSelector(std::shared_ptr<const Engine> engine)
+    : session_(std::move(engine)), capacity_(std::max<size_t>(1, session_.engine()->settings().burst_candidates)) {
+    candidates_.reserve(capacity_);
+}
+
+BurstSelector::~BurstSelector() = default;
+
+float BurstSelector::scoreFrame(const preprocessing::DocumentBounds& bounds) {
+    // The quality gate has already measured the frame when it is enabled
+    const preprocessing::QualitySettings& quality = session_.engine()->settings().quality;
+    double sharpness = quality.gate_enabled ? session_.quality().sharpness : session_.measureQuality().sharpness;
+    double reference = quality.min_sharpness > 0.0 ? quality.min_sharpness : 1.0;
+    double sharpness_term = sharpness / (sharpness + reference);
+    
+    // A frame with no detection before it has no evidence of being steady
+    double stability_term = 0.0;
+    if (has_previous_) {
+        double movement = meanCornerMovement(bounds, previous_bounds_);
+        stability_term = kStabilityScale / (kStabilityScale + movement);
+    }
+    
+    return static_cast<float>(kSharpnessWeight * sharpness_term +
+                              kConfidenceWeight * bounds.confidence +
+                              kStabilityWeight * stability_term);
+}
+
+id_reader_error_t BurstSelector::pushFrame(const id_reader_image_t& image, float& score) {
+    session_.timings().reset();
+    ID_READER_TIME_STAGE(session_.collectsStats() ? &session_.timings() : nullptr, total_ms);
+    
+    score = 0.0f;
+    preprocessing::DocumentBounds bounds;
+    id_reader_error_t error = session_.detectDocument(image, bounds);
+    if (error != ID_READER_SUCCESS) {
+        has_previous_ = false;
+        return error;
+    }
+    
+    score = scoreFrame(bounds);
+    previous_bounds_ = bounds;
+    has_previous_ = true;
+    
+    // Fill empty slots first, then replace the weakest retained frame
+    BurstCandidate* slot = nullptr;
+    if (candidates_.size() < capacity_) {
+        candidates_.emplace_back();
+        slot = &candidates_.back();
+    } else {
+        auto weakest = std::min_element(candidates_.begin(), candidates_.end(),
+            [](const BurstCandidate& a, const BurstCandidate& b) { return a.score < b.score; });
+        if (weakest->score >= score) {
+            return ID_READER_SUCCESS;
+        }
+        slot = &*weakest;
+    }
+    
+    // The session's luma may wrap the caller's buffer, so retained frames
+    // need their own copy; same-sized frames reuse the slot's allocation
+    session_.luma().copyTo(slot->luma);
+    slot->bounds = bounds;
+    slot->score = score;
+    return ID_READER_SUCCESS;
+}
+
+const BurstCandidate* BurstSelector::best() const {
+    auto best = std::max_element(candidates_.begin(), candidates_.end(),
+        [](const BurstCandidate& a, const BurstCandidate& b) { return a.score < b.score; });
+    return best == candidates_.end() ? nullptr : &*best;
+}
+
+id_reader_error_t BurstSelector::finish(ProcessingOutput& output) {
+    if (candidates_.empty()) {
+        return ID_READER_ERROR_NO_DOCUMENT_FOUND;
+    }
+    
+    std::vector<size_t> order(candidates_.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return candidates_[a].score > candidates_[b].score;
+    });
+    
+    // A frame the downstream stages read nothing from (rectification failed,
+    // no barcode, MRZ or field was recognized) falls through to the next best
+    id_reader_error_t error = ID_READER_ERROR_NO_DOCUMENT_FOUND;
+    bool have_fallback = false;
+    for (size_t index : order) {
+        const BurstCandidate& candidate = candidates_[index];
+        error = session_.extractDocument(candidate.luma, candidate.bounds, output);
+        if (error != ID_READER_SUCCESS) {
+            continue;
+        }
+        if (output.extracted) {
+            return ID_READER_SUCCESS;
+        }
+        if (!have_fallback) {
+            fallback_ = output;
+            have_fallback = true;
+        }
+    }
+    
+    // Nothing was read from any frame (or the engine has no extraction
+    // stages): the best detected frame's bounds are the result
+    if (have_fallback) {
+        output = fallback_;
+        return ID_READER_SUCCESS;
+    }
+    return error;
+}
+
+} // namespace core
+} // namespace id_reader
@@ -0,0 +1,71 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_BURST_SELECTOR_H
+#define ID_READER_BURST_SELECTOR_H
+
+#include "id_reader/id_reader.h"
+#include "session.h"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <vector>
+
+namespace id_reader {
+namespace core {
+
+// One retained burst frame
+struct BurstCandidate {
+    cv::Mat luma;  // Copy of the frame's luma plane, reused when the slot is replaced
+    preprocessing::DocumentBounds bounds;
+    float score = 0.0f;
+};
+
+// Picks the best frame of a capture burst. Every pushed frame goes through
+// detection only and is scored on sharpness, detection confidence and how
+// little the corners moved since the previous frame. The best
+// `burst_candidates` frames are kept in fixed slots, so memory does not grow
+// with burst length, and the downstream stages run only on the winner (or,
+// should they read nothing there, on the next best in turn).
+class BurstSelector {
+public:
+    explicit BurstSelector(std::shared_ptr<const Engine> engine);
+    ~BurstSelector();
+    
+    BurstSelector(const BurstSelector&) = delete;
+    BurstSelector& operator=(const BurstSelector&) = delete;
+    
+    // Detect and score one frame. `score` is 0 for frames without a document.
+    id_reader_error_t pushFrame(const id_reader_image_t& image, float& score);
+    
+    // Run extraction on the best retained frame, falling back to the next
+    // best while nothing is read. Without any read, the best frame's bounds
+    // are the result.
+    id_reader_error_t finish(ProcessingOutput& output);
+    
+    // Highest-scoring retained frame, or nullptr before any detection
+    const BurstCandidate* best() const;
+    
+    Session& session() { return session_; }
+    
+private:
+    float scoreFrame(const preprocessing::DocumentBounds& bounds);
+    
+    Session session_;
+    std::vector<BurstCandidate> candidates_;  // Retained frames, at most capacity_
+    size_t capacity_;
+    preprocessing::DocumentBounds previous_bounds_;
+    bool has_previous_ = false;  // Whether the last pushed frame had a document
+    ProcessingOutput fallback_;  // Best frame's output while runners-up are tried
+};
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_BURST_SELECTOR_H
@@ -0,0 +1,202 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "engine.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+namespace id_reader {
+namespace core {
+
+namespace {
+
+double getDouble(const ConfigMap& config, const char* key, double fallback) {
+    auto it = config.find(key);
+    return it == config.end() ? fallback : std::stod(it->second);
+}
+
+int getInt(const ConfigMap& config, const char* key, int fallback) {
+    auto it = config.find(key);
+    return it == config.end() ? fallback : std::stoi(it->second);
+}
+
+std::string getString(const ConfigMap& config, const char* key, const std::string& fallback) {
+    auto it = config.find(key);
+    return it == config.end() ? fallback : it->second;
+}
+
+bool getBool(const ConfigMap& config, const char* key, bool fallback) {
+    auto it = config.find(key);
+    if (it == config.end()) {
+        return fallback;
+    }
+    return it->second == "1" || it->second == "true";
+}
+
+preprocessing::DetectorEngine getDetectorEngine(const ConfigMap& config, const char* key,
+                                                preprocessing::DetectorEngine fallback) {
+    auto it = config.find(key);
+    if (it == config.end()) {
+        return fallback;
+    }
+    if (it->second == "contour") {
+        return preprocessing::DetectorEngine::Contour;
+    }
+    if (it->second == "lines") {
+        return preprocessing::DetectorEngine::Lines;
+    }
+    throw std::invalid_argument("unknown detector engine: " + it->second);
+}
+
+QueuePolicy getQueuePolicy(const ConfigMap& config, const char* key, QueuePolicy fallback) {
+    auto it = config.find(key);
+    if (it == config.end()) {
+        return fallback;
+    }
+    if (it->second == "block") {
+        return QueuePolicy::Block;
+    }
+    if (it->second == "drop_oldest") {
+        return QueuePolicy::DropOldest;
+    }
+    if (it->second == "drop_newest") {
+        return QueuePolicy::DropNewest;
+    }
+    throw std::invalid_argument("unknown queue policy: " + it->second);
+}
+
+} // namespace
+
+EngineSettings parseEngineSettings(const ConfigMap& config) {
+    EngineSettings settings;
+    
+    preprocessing::DetectorSettings& detector = settings.detector;
+    detector.engine = getDetectorEngine(config, "detector_engine", detector.engine);
+    detector.canny_threshold1 = getDouble(config, "canny_threshold1", detector.canny_threshold1);
+    detector.canny_threshold2 = getDouble(config, "canny_threshold2", detector.canny_threshold2);
+    detector.min_contour_area = getDouble(config, "min_contour_area", detector.min_contour_area);
+    detector.max_contour_area = getDouble(config, "max_contour_area", detector.max_contour_area);
+    detector.approx_epsilon_factor = getDouble(config, "approx_epsilon", detector.approx_epsilon_factor);
+    detector.pyramid_enabled = getBool(config, "pyramid_detection", detector.pyramid_enabled);
+    detector.pyramid_max_dimension = std::max(64, getInt(config, "pyramid_max_dimension",
+                                                         detector.pyramid_max_dimension));
+    detector.fused_preprocessing = getBool(config, "fused_preprocessing", detector.fused_preprocessing);
+    detector.parallel_preprocessing = getBool(config, "parallel_preprocessing", detector.parallel_preprocessing);
+    detector.line_vote_threshold = std::max(1, getInt(config, "line_vote_threshold", detector.line_vote_threshold));
+    detector.line_min_length_factor = getDouble(config, "line_min_length", detector.line_min_length_factor);
+    detector.line_min_coverage = getDouble(config, "line_min_coverage", detector.line_min_coverage);
+    
+    preprocessing::QualitySettings& quality = settings.quality;
+    quality.gate_enabled = getBool(config, "quality_gate", quality.gate_enabled);
+    quality.max_dimension = std::max(32, getInt(config, "quality_max_dimension", quality.max_dimension));
+    quality.min_sharpness = getDouble(config, "quality_min_sharpness", quality.min_sharpness);
+    quality.glare_level = getInt(config, "quality_glare_level", quality.glare_level);
+    quality.max_glare_ratio = getDouble(config, "quality_max_glare", quality.max_glare_ratio);
+    quality.min_brightness = getDouble(config, "quality_min_brightness", quality.min_brightness);
+    quality.max_brightness = getDouble(config, "quality_max_brightness", quality.max_brightness);
+    
+    extraction::OcrSettings& ocr = settings.ocr;
+    ocr.enabled = getBool(config, "ocr_enabled", ocr.enabled);
+    ocr.tessdata_path = getString(config, "tessdata_path", ocr.tessdata_path);
+    ocr.language = getString(config, "ocr_language", ocr.language);
+    ocr.dpi = std::max(72.0, getDouble(config, "ocr_dpi", ocr.dpi));
+    ocr.min_confidence = static_cast<float>(getDouble(config, "ocr_min_confidence", ocr.min_confidence));
+    ocr.mrz_templates_path = getString(config, "mrz_templates", ocr.mrz_templates_path);
+    
+    extraction::BarcodeSettings& barcode = settings.barcode;
+    barcode.enabled = getBool(config, "barcode_enabled", barcode.enabled);
+    barcode.codebook_path = getString(config, "pdf417_codebook", barcode.codebook_path);
+    barcode.dpi = std::max(150.0, getDouble(config, "barcode_dpi", barcode.dpi));
+    
+    classification::ClassifierSettings& classifier = settings.classifier;
+    classifier.enabled = getBool(config, "classifier_enabled", classifier.enabled);
+    classifier.model_path = getString(config, "classifier_model", classifier.model_path);
+    classifier.temperature = static_cast<float>(getDouble(config, "classifier_temperature", classifier.temperature));
+    classifier.min_confidence = static_cast<float>(getDouble(config, "classifier_min_confidence",
+                                                             classifier.min_confidence));
+    classifier.threads = std::max(1, getInt(config, "classifier_threads", classifier.threads));
+    
+    settings.tracking_margin = getDouble(config, "tracking_margin", settings.tracking_margin);
+    settings.tracking_smoothing = static_cast<float>(
+        getDouble(config, "tracking_smoothing", settings.tracking_smoothing));
+    
+    settings.burst_candidates = static_cast<size_t>(std::max(1, getInt(config, "burst_candidates",
+                                                                        static_cast<int>(settings.burst_candidates))));
+    
+    settings.batch_threads = static_cast<size_t>(std::max(0, getInt(config, "batch_threads", 0)));
+    settings.async_threads = static_cast<size_t>(std::max(0, getInt(config, "async_threads", 0)));
+    settings.async_extract_threads = static_cast<size_t>(std::max(1, getInt(config, "async_extract_threads",
+                                                                            static_cast<int>(settings.async_extract_threads))));
+    settings.async_max_pending = static_cast<size_t>(std::max(1, getInt(config, "async_max_pending",
+                                                                        static_cast<int>(settings.async_max_pending))));
+    settings.async_queue_policy = getQueuePolicy(config, "async_queue_policy", settings.async_queue_policy);
+    settings.preprocess_threads = static_cast<size_t>(std::max(0, getInt(config, "preprocess_threads", 0)));
+    settings.collect_stats = getBool(config, "collect_stats", settings.collect_stats);
+    
+    return settings;
+}
+
+Engine::Engine(const ConfigMap& config, std::shared_ptr<const AssetBundle> bundle)
+    : config_(config), settings_(parseEngineSettings(config)), bundle_(std::move(bundle)) {
+    if (settings_.detector.parallel_preprocessing) {
+        preprocess_pool_ = std::make_unique<ThreadPool>(settings_.preprocess_threads);
+    }
+    if (settings_.ocr.enabled) {
+        // Tesseract starts initializing now, in the background, for the
+        // context's own session and each async extraction worker; batch
+        // workers (the hardware thread count by default) take further engines
+        // on first use
+        ocr_pool_ = std::make_unique<extraction::OcrEnginePool>(settings_.ocr, 1 + settings_.async_extract_threads);
+    }
+}
+
+Engine::~Engine() = default;
+
+const extraction::MrzTemplates* Engine::mrzTemplates(id_reader_document_type_t type,
+                                                     id_reader_country_t country) const {
+    // The template reader needs no Tesseract, so ocr_enabled does not apply
+    const extraction::OcrSettings& ocr = settings_.ocr;
+    if (!ocr.mrz_templates_path.empty()) {
+        std::call_once(mrz_templates_once_, [this] { mrz_templates_.load(settings_.ocr.mrz_templates_path); });
+        return mrz_templates_.empty() ? nullptr : &mrz_templates_;
+    }
+    return bundle_ ? bundle_->mrzTemplates(type, country) : nullptr;
+}
+
+const extraction::Pdf417Codebook* Engine::pdf417Codebook() const {
+    const extraction::BarcodeSettings& barcode = settings_.barcode;
+    if (!barcode.enabled) {
+        return nullptr;
+    }
+    if (!barcode.codebook_path.empty()) {
+        std::call_once(pdf417_codebook_once_, [this] { pdf417_codebook_.load(settings_.barcode.codebook_path); });
+        return pdf417_codebook_.empty() ? nullptr : &pdf417_codebook_;
+    }
+    // AAMVA barcodes are read before the document is classified
+    return bundle_ ? bundle_->pdf417Codebook() : nullptr;
+}
+
+const classification::ClassifierModel* Engine::classifierModel() const {
+    const classification::ClassifierSettings& classifier = settings_.classifier;
+    if (!classifier.enabled) {
+        return nullptr;
+    }
+    if (!classifier.model_path.empty()) {
+        std::call_once(classifier_model_once_, [this] {
+            classifier_model_ = classification::ClassifierModel::load(settings_.classifier.model_path);
+        });
+        return classifier_model_.get();
+    }
+    return bundle_ ? bundle_->classifierModel() : nullptr;
+}
+
+} // namespace core
+} // namespace id_reader
@@ -0,0 +1,135 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_ENGINE_H
+#define ID_READER_ENGINE_H
+
+#include "../preprocessing/document_detection/document_detector_base.h"
+#include "../preprocessing/quality/quality_assessor.h"
+#include "asset_bundle.h"
+#include "../classification/document_classifier.h"
+#include "../extraction/barcode/pdf417_reader.h"
+#include "../extraction/mrz/mrz_reader.h"
+#include "../extraction/ocr/ocr_engine_pool.h"
+#include "pipeline_executor.h"
+#include "thread_pool.h"
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace id_reader {
+namespace core {
+
+using ConfigMap = std::map<std::string, std::string>;
+
+struct EngineSettings {
+    preprocessing::DetectorSettings detector;
+    preprocessing::QualitySettings quality;
+    extraction::OcrSettings ocr;
+    extraction::BarcodeSettings barcode;
+    classification::ClassifierSettings classifier;
+    
+    // Video stream tracking
+    double tracking_margin = 0.15;
+    float tracking_smoothing = 0.6f;
+    
+    // Frames retained by burst capture for the final pick
+    size_t burst_candidates = 3;
+    
+    // Worker threads for batch processing (0 = hardware threads)
+    size_t batch_threads = 0;
+    
+    // id_reader_process_image_async pipeline: detection threads (0 = hardware
+    // threads), extraction threads, how many submitted images may wait for
+    // detection and what happens to a new image when that many are already
+    // waiting
+    size_t async_threads = 0;
+    size_t async_extract_threads = 1;
+    size_t async_max_pending = 2;
+    QueuePolicy async_queue_policy = QueuePolicy::DropOldest;
+    
+    // Worker threads for stripe-parallel preprocessing (0 = hardware threads)
+    size_t preprocess_threads = 0;
+    
+    // Record per-stage timings for id_reader_get_stats (needs a library
+    // built with ENABLE_STAGE_TIMING)
+    bool collect_stats = false;
+};
+
+// Parse configuration key/value pairs into typed settings. Unknown keys are
+// ignored; malformed values throw std::invalid_argument or std::out_of_range.
+EngineSettings parseEngineSettings(const ConfigMap& config);
+
+// Immutable processing engine: configuration fixed at construction. Engines
+// are shared between threads through std::shared_ptr<const Engine>;
+// everything mutable lives in Session. Models and templates are loaded on
+// first use rather than at construction, once, under std::call_once: from
+// the path in their config key when one is set, otherwise from the asset
+// bundle.
+class Engine {
+public:
+    explicit Engine(const ConfigMap& config, std::shared_ptr<const AssetBundle> bundle = nullptr);
+    ~Engine();
+    
+    Engine(const Engine&) = delete;
+    Engine& operator=(const Engine&) = delete;
+    
+    const EngineSettings& settings() const { return settings_; }
+    const ConfigMap& config() const { return config_; }
+    
+    // Pool for stripe-parallel preprocessing, or nullptr when that mode is
+    // off. The pool synchronizes internally, so sessions on different
+    // threads may share it.
+    ThreadPool* preprocessPool() const { return preprocess_pool_.get(); }
+    
+    // OCR engines for field extraction, or nullptr when OCR is off. Like the
+    // preprocessing pool, it synchronizes internally.
+    extraction::OcrEnginePool* ocrPool() const { return ocr_pool_.get(); }
+    
+    // Asset bundle the engine was created with, if any
+    const std::shared_ptr<const AssetBundle>& bundle() const { return bundle_; }
+    
+    // MRZ glyph templates for a document type and country; nullptr when none
+    // are configured or they failed to load. Independent of ocr_enabled.
+    const extraction::MrzTemplates* mrzTemplates(
+        id_reader_document_type_t type = ID_READER_DOCUMENT_UNKNOWN,
+        id_reader_country_t country = ID_READER_COUNTRY_UNKNOWN) const;
+    
+    // PDF417 codeword table; nullptr when barcodes are off or none is
+    // configured or it failed to load
+    const extraction::Pdf417Codebook* pdf417Codebook() const;
+    
+    // Classification model, mapped once and shared by every session's
+    // interpreter; nullptr when classification is off or the model failed
+    // to load
+    const classification::ClassifierModel* classifierModel() const;
+    
+private:
+    ConfigMap config_;
+    EngineSettings settings_;
+    std::unique_ptr<ThreadPool> preprocess_pool_;
+    std::unique_ptr<extraction::OcrEnginePool> ocr_pool_;
+    std::shared_ptr<const AssetBundle> bundle_;
+    
+    // Assets named by config paths, loaded on first use
+    mutable std::once_flag mrz_templates_once_;
+    mutable extraction::MrzTemplates mrz_templates_;
+    mutable std::once_flag pdf417_codebook_once_;
+    mutable extraction::Pdf417Codebook pdf417_codebook_;
+    mutable std::once_flag classifier_model_once_;
+    mutable std::unique_ptr<classification::ClassifierModel> classifier_model_;
+};
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_ENGINE_H
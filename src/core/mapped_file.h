@@ -0,0 +1,52 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_MAPPED_FILE_H
+#define ID_READER_MAPPED_FILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace id_reader {
+namespace core {
+
+// Read-only memory mapping of a whole file. Pages are read from disk when
+// first touched and, being clean file-backed pages, can be dropped again
+// under memory pressure and are shared between processes mapping the same
+// file.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    // Map `path`, replacing any current mapping. Access is advised as random,
+    // so touching one section does not read ahead into its neighbours.
+    bool open(const std::string& path);
+    void close();
+    
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    
+private:
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void* mapping_ = nullptr;  // File mapping object handle
+#endif
+};
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_MAPPED_FILE_H
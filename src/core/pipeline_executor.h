@@ -0,0 +1,237 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_PIPELINE_EXECUTOR_H
+#define ID_READER_PIPELINE_EXECUTOR_H
+
+#include "bounded_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace id_reader {
+namespace core {
+
+// What submit does when the first stage's queue is full
+enum class QueuePolicy {
+    Block,       // Wait for space: backpressure reaches the submitting thread
+    DropOldest,  // Drop the longest-waiting item to make room
+    DropNewest   // Drop the item being submitted
+};
+
+// Sleep/wake helper for threads waiting on a lock-free queue. The mutex is
+// only taken by threads that found nothing to do and by notifiers that see a
+// sleeper, so the busy path stays lock-free.
+class QueueSignal {
+public:
+    // Block until ready() returns true. ready() is re-evaluated under the
+    // mutex after registering as a waiter, so a notify cannot be lost.
+    template <typename Ready>
+    void wait(Ready ready) {
+        if (ready()) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        waiters_.fetch_add(1);
+        while (!ready()) {
+            condition_.wait(lock);
+        }
+        waiters_.fetch_sub(1);
+    }
+    
+    void notifyAll() {
+        // Orders the caller's queue update before the waiter check; pairs
+        // with the seq_cst increment in wait()
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load() > 0) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            condition_.notify_all();
+        }
+    }
+    
+private:
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::atomic<int> waiters_{0};
+};
+
+// Runs items through a fixed sequence of stages, each with its own worker
+// threads, connected by bounded lock-free queues. Stage workers block when
+// the next stage's queue is full, so a slow later stage holds back earlier
+// ones instead of letting work pile up; only the entry queue applies a drop
+// policy, and it holds exactly `queue_capacity` items even though the
+// queues round their capacity up to a power of two. With two stages, frame
+// N+1 is detected while frame N is still in extraction.
+template <typename T>
+class PipelineExecutor {
+public:
+    // Returns true to pass the item on to the next stage, false once the
+    // stage has finished with it
+    using StageFunction = std::function<bool(T& item, size_t worker)>;
+    // Receives items dropped by the entry policy or abandoned at shutdown
+    using DropFunction = std::function<void(T& item)>;
+    
+    struct StageConfig {
+        size_t workers;
+        StageFunction run;
+    };
+    
+    PipelineExecutor(const std::vector<StageConfig>& stages, size_t queue_capacity, QueuePolicy policy,
+                     DropFunction drop)
+        : policy_(policy), drop_(std::move(drop)), entry_limit_(std::max<size_t>(1, queue_capacity)) {
+        for (const StageConfig& config : stages) {
+            stages_.push_back(std::make_unique<Stage>(std::max<size_t>(1, queue_capacity), config.run));
+        }
+        for (size_t index = 0; index < stages_.size(); ++index) {
+            size_t workers = std::max<size_t>(1, stages[index].workers);
+            stages_[index]->active_workers.store(workers);
+            for (size_t worker = 0; worker < workers; ++worker) {
+                stages_[index]->threads.emplace_back(&PipelineExecutor::workerLoop, this, index, worker);
+            }
+        }
+    }
+    
+    // Items still queued are dropped; items inside a stage function finish
+    // that stage first
+    ~PipelineExecutor() {
+        stopping_.store(true);
+        for (auto& stage : stages_) {
+            stage->items.notifyAll();
+            stage->space.notifyAll();
+        }
+        for (auto& stage : stages_) {
+            for (auto& thread : stage->threads) {
+                thread.join();
+            }
+        }
+    }
+    
+    PipelineExecutor(const PipelineExecutor&) = delete;
+    PipelineExecutor& operator=(const PipelineExecutor&) = delete;
+    
+    // Queue an item for the first stage, applying the entry policy when the
+    // queue is full. Dropped items go to the drop function on this thread.
+    void submit(T item) {
+        Stage& entry = *stages_.front();
+        switch (policy_) {
+            case QueuePolicy::Block:
+                entry.space.wait([&] { return tryPushEntry(item); });
+                break;
+            case QueuePolicy::DropNewest:
+                if (!tryPushEntry(item)) {
+                    drop_(item);
+                    return;
+                }
+                break;
+            case QueuePolicy::DropOldest:
+                while (!tryPushEntry(item)) {
+                    T oldest;
+                    if (entry.queue.tryPop(oldest)) {
+                        entry_count_.fetch_sub(1);
+                        drop_(oldest);
+                    }
+                }
+                break;
+        }
+        entry.items.notifyAll();
+    }
+    
+private:
+    struct Stage {
+        Stage(size_t capacity, StageFunction function) : queue(capacity), run(std::move(function)) {}
+        
+        BoundedQueue<T> queue;
+        StageFunction run;
+        QueueSignal items;   // Signalled when an item is queued or the stage may exit
+        QueueSignal space;   // Signalled when an item leaves the queue
+        std::vector<std::thread> threads;
+        std::atomic<size_t> active_workers{0};
+    };
+    
+    // Blocking push: waits for a consumer of `stage` to make room
+    void push(Stage& stage, T& item) {
+        stage.space.wait([&] { return stage.queue.tryPush(item); });
+        stage.items.notifyAll();
+    }
+    
+    // Push onto the entry queue unless entry_limit_ items already wait there.
+    // A slot counted free is free in the queue too, as pops are uncounted
+    // only once they complete; the retry covers contention with other
+    // producers for the same cell.
+    bool tryPushEntry(T& item) {
+        size_t count = entry_count_.load();
+        do {
+            if (count >= entry_limit_) {
+                return false;
+            }
+        } while (!entry_count_.compare_exchange_weak(count, count + 1));
+        Stage& entry = *stages_.front();
+        while (!entry.queue.tryPush(item)) {
+            std::this_thread::yield();
+        }
+        return true;
+    }
+    
+    // A stage is finished once shutdown has begun and every stage before it
+    // has stopped feeding it
+    bool upstreamDone(size_t index) const {
+        return stopping_.load() && (index == 0 || stages_[index - 1]->active_workers.load() == 0);
+    }
+    
+    void workerLoop(size_t index, size_t worker) {
+        Stage& stage = *stages_[index];
+        Stage* next = index + 1 < stages_.size() ? stages_[index + 1].get() : nullptr;
+        
+        for (;;) {
+            T item;
+            bool have_item = false;
+            stage.items.wait([&] {
+                have_item = stage.queue.tryPop(item);
+                return have_item || upstreamDone(index);
+            });
+            if (!have_item) {
+                break;
+            }
+            if (index == 0) {
+                entry_count_.fetch_sub(1);
+            }
+            stage.space.notifyAll();
+            
+            if (stopping_.load()) {
+                drop_(item);
+            } else if (stage.run(item, worker) && next) {
+                push(*next, item);
+            }
+        }
+        
+        // The last worker out lets the next stage's workers exit too
+        if (stage.active_workers.fetch_sub(1) == 1 && next) {
+            next->items.notifyAll();
+        }
+    }
+    
+    QueuePolicy policy_;
+    DropFunction drop_;
+    const size_t entry_limit_;
+    std::atomic<size_t> entry_count_{0};  // Items in, or being pushed onto, the entry queue
+    std::atomic<bool> stopping_{false};
+    std::vector<std::unique_ptr<Stage>> stages_;
+};
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_PIPELINE_EXECUTOR_H
@@ -0,0 +1,351 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "session.h"
+#include "../extraction/barcode/aamva_parser.h"
+#include "../preprocessing/image_ingest/image_ingest.h"
+#include <algorithm>
+
+namespace id_reader {
+namespace core {
+
+namespace {
+
+// Confidence scale for MRZ text whose check digits do not match
+constexpr float kFailedCheckPenalty = 0.5f;
+
+} // namespace
+
+Session::Session(std::shared_ptr<const Engine> engine)
+    : engine_(std::move(engine)), detector_(preprocessing::createDocumentDetector(engine_->settings().detector)) {
+#ifdef ENABLE_STAGE_TIMING
+    collect_stats_ = engine_->settings().collect_stats;
+#endif
+    if (collect_stats_) {
+        detector_->setStageTimings(&timings_);
+    }
+    detector_->setParallelPreprocessing(engine_->settings().detector.parallel_preprocessing,
+                                        engine_->preprocessPool());
+}
+
+Session::~Session() = default;
+
+id_reader_error_t Session::ingest(const id_reader_image_t& image) {
+    if (!image.data || image.width == 0 || image.height == 0) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    // Ingest straight to the luma plane the detector works on
+    ID_READER_TIME_STAGE(collect_stats_ ? &timings_ : nullptr, ingest_ms);
+    if (!preprocessing::ingestLuma(image, luma_)) {
+        return ID_READER_ERROR_UNSUPPORTED_FORMAT;
+    }
+    return ID_READER_SUCCESS;
+}
+
+id_reader_error_t Session::assessQuality(const id_reader_image_t& image, preprocessing::QualityReport& report) {
+    id_reader_error_t error = ingest(image);
+    if (error != ID_READER_SUCCESS) {
+        return error;
+    }
+    
+    report = measureQuality();
+    return ID_READER_SUCCESS;
+}
+
+const preprocessing::QualityReport& Session::measureQuality() {
+    quality_assessor_.assess(luma_, engine_->settings().quality, quality_);
+    return quality_;
+}
+
+id_reader_error_t Session::checkQuality() {
+    const preprocessing::QualitySettings& settings = engine_->settings().quality;
+    if (!settings.gate_enabled) {
+        return ID_READER_SUCCESS;
+    }
+    
+    ID_READER_TIME_STAGE(collect_stats_ ? &timings_ : nullptr, quality_ms);
+    return measureQuality().acceptable() ? ID_READER_SUCCESS : ID_READER_ERROR_LOW_QUALITY;
+}
+
+id_reader_error_t Session::rectify(const id_reader_image_t& image, const preprocessing::DocumentBounds& bounds,
+                                   const preprocessing::RectifySettings& settings, bool color, cv::Mat& output) {
+    if (!image.data || image.width == 0 || image.height == 0) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    
+    cv::Mat pixels;
+    if (color) {
+        if (!preprocessing::wrapPackedPixels(image, pixels)) {
+            return ID_READER_ERROR_UNSUPPORTED_FORMAT;
+        }
+    } else {
+        id_reader_error_t error = ingest(image);
+        if (error != ID_READER_SUCCESS) {
+            return error;
+        }
+        pixels = luma_;
+    }
+    
+    if (!rectifier_.rectify(pixels, bounds, settings, output)) {
+        return ID_READER_ERROR_INVALID_INPUT;
+    }
+    return ID_READER_SUCCESS;
+}
+
+id_reader_error_t Session::processImage(const id_reader_image_t& image, ProcessingOutput& output) {
+    timings_.reset();
+    ID_READER_TIME_STAGE(collect_stats_ ? &timings_ : nullptr, total_ms);
+    
+    id_reader_error_t error = detectDocument(image, output.bounds);
+    if (error != ID_READER_SUCCESS) {
+        return error;
+    }
+    
+    return extractDocument(luma_, output.bounds, output);
+}
+
+id_reader_error_t Session::detectDocument(const id_reader_image_t& image, preprocessing::DocumentBounds& bounds) {
+    id_reader_error_t error = ingest(image);
+    if (error != ID_READER_SUCCESS) {
+        return error;
+    }
+    
+    // Unusable frames stop here, before the expensive stages
+    error = checkQuality();
+    if (error != ID_READER_SUCCESS) {
+        return error;
+    }
+    
+    if (!detector_->detectDocument(luma_, bounds)) {
+        return ID_READER_ERROR_NO_DOCUMENT_FOUND;
+    }
+    return ID_READER_SUCCESS;
+}
+
+id_reader_error_t Session::extractDocument(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds,
+                                           ProcessingOutput& output) {
+    output.bounds = bounds;
+    output.document_type = ID_READER_DOCUMENT_UNKNOWN;
+    output.country = ID_READER_COUNTRY_UNKNOWN;
+    output.document_type_confidence = 0.0f;
+    output.country_confidence = 0.0f;
+    output.fields.clear();
+    output.extracted = false;
+    
+    // A licence barcode carries every field and says what the document is;
+    // classification and OCR run only without one
+    if (!readBarcode(luma, bounds, output)) {
+        classify(luma, bounds, output);
+        recognizeFields(luma, bounds, output);
+    }
+    output.overall_confidence = output.bounds.confidence;
+    output.extracted = !output.fields.empty() || output.document_type != ID_READER_DOCUMENT_UNKNOWN;
+    return ID_READER_SUCCESS;
+}
+
+void Session::recognizeFields(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds,
+                              ProcessingOutput& output) {
+    // Classification has run by now, so a bundle may supply templates
+    // specific to the document's country. The MRZ is the only region read:
+    // the template reader needs no Tesseract and runs with OCR off, while
+    // its Tesseract fallback follows ocr_enabled.
+    const extraction::OcrSettings& settings = engine_->settings().ocr;
+    const extraction::MrzTemplates* templates = engine_->mrzTemplates(output.document_type, output.country);
+    if (!settings.enabled && !templates) {
+        return;
+    }
+    
+    preprocessing::RectifySettings rectify_settings;
+    rectify_settings.format = preprocessing::DocumentRectifier::resolveFormat(preprocessing::DocumentFormat::Auto,
+                                                                              bounds, luma.size());
+    rectify_settings.dpi = settings.dpi;
+    {
+        ID_READER_TIME_STAGE(collect_stats_ ? &timings_ : nullptr, rectify_ms);
+        if (!rectifier_.rectify(luma, bounds, rectify_settings, field_crop_)) {
+            return;
+        }
+    }
+    
+    // The crop is handed to Tesseract at most once; each line only moves
+    // its rectangle, so nothing outside the MRZ band is recognized
+    bool ocr_ready = false;
+    extraction::MrzFormat format = rectify_settings.format == preprocessing::DocumentFormat::Td3
+        ? extraction::MrzFormat::Td3 : extraction::MrzFormat::Td1;
+    for (const extraction::FieldRegion& region : extraction::fieldLayout(rectify_settings.format)) {
+        ID_READER_TIME_STAGE(collect_stats_ ? &timings_ : nullptr, mrz_ms);
+        readMrz(extraction::fieldRect(region, field_crop_.size()), format, templates, ocr_ready, output);
+    }
+}
+
+bool Session::readBarcode(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds,
+                          ProcessingOutput& output) {
+    const extraction::BarcodeSettings& settings = engine_->settings().barcode;
+    const extraction::Pdf417Codebook* codebook = engine_->pdf417Codebook();
+    if (!codebook) {
+        return false;
+    }
+    
+    // Licences are ID-1 cards; passport pages carry no PDF417
+    ID_READER_TIME_STAGE(collect_stats_ ? &timings_ : nullptr, barcode_ms);
+    preprocessing::RectifySettings rectify_settings;
+    rectify_settings.format = preprocessing::DocumentRectifier::resolveFormat(preprocessing::DocumentFormat::Auto,
+                                                                              bounds, luma.size());
+    if (rectify_settings.format != preprocessing::DocumentFormat::Id1) {
+        return false;
+    }
+    rectify_settings.dpi = settings.dpi;
+    extraction::AamvaData data;
+    if (!rectifier_.rectify(luma, bounds, rectify_settings, barcode_crop_) ||
+        !pdf417_reader_.read(barcode_crop_, *codebook, pdf417_symbol_) ||
+        !extraction::parseAamva(pdf417_symbol_.data, data)) {
+        return false;
+    }
+    
+    // Every field comes from the one error-corrected symbol
+    float confidence = pdf417_symbol_.confidence();
+    cv::Rect box = rectifier_.sourceRect(pdf417_symbol_.box);
+    for (extraction::AamvaField& aamva_field : data.fields) {
+        ExtractedField field;
+        field.name = std::move(aamva_field.name);
+        field.value = std::move(aamva_field.value);
+        field.confidence = confidence;
+        field.box = box;
+        output.fields.push_back(std::move(field));
+    }
+    output.document_type = data.drivers_license ? ID_READER_DOCUMENT_DRIVERS_LICENSE : ID_READER_DOCUMENT_ID_CARD;
+    output.country = data.canadian ? ID_READER_COUNTRY_CA : ID_READER_COUNTRY_US;
+    output.document_type_confidence = confidence;
+    output.country_confidence = confidence;
+    return true;
+}
+
+void Session::classify(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds, ProcessingOutput& output) {
+    const classification::ClassifierModel* model = engine_->classifierModel();
+    if (!model || classifier_failed_) {
+        return;
+    }
+    
+    ID_READER_TIME_STAGE(collect_stats_ ? &timings_ : nullptr, classify_ms);
+    if (!classifier_) {
+        classifier_ = std::make_unique<classification::DocumentClassifier>(*model, engine_->settings().classifier);
+        if (!classifier_->ready()) {
+            classifier_.reset();
+            classifier_failed_ = true;
+            return;
+        }
+    }
+    
+    classification::Classification classification;
+    if (!classifier_->classify(luma, bounds, rectifier_, classification)) {
+        return;
+    }
+    output.document_type = classification.document_type;
+    output.document_type_confidence = classification.document_type_confidence;
+    output.country = classification.country;
+    output.country_confidence = classification.country_confidence;
+}
+
+bool Session::prepareOcr(bool& image_set) {
+    if (!ocr_) {
+        extraction::OcrEnginePool* pool = engine_->ocrPool();
+        if (!pool) {
+            return false;
+        }
+        ocr_ = pool->acquire();
+        if (!ocr_) {
+            return false;  // No usable Tesseract data
+        }
+    }
+    if (!image_set) {
+        ocr_->setImage(field_crop_, engine_->settings().ocr.dpi);
+        image_set = true;
+    }
+    return true;
+}
+
+void Session::readMrz(const cv::Rect& rect, extraction::MrzFormat format, const extraction::MrzTemplates* templates,
+                      bool& ocr_ready, ProcessingOutput& output) {
+    const extraction::OcrSettings& settings = engine_->settings().ocr;
+    extraction::MrzReading& reading = mrz_reading_;
+    if (!mrz_reader_.segment(field_crop_(rect), format, settings.dpi, reading)) {
+        return;
+    }
+    
+    if (templates) {
+        mrz_reader_.classify(*templates, reading);
+    } else {
+        // No glyph templates: Tesseract reads the located lines instead
+        if (!settings.enabled || !prepareOcr(ocr_ready)) {
+            return;
+        }
+        const extraction::FieldRegion line_region = {"mrz", cv::Rect2f(), extraction::kMrzAlphabet, true};
+        for (const extraction::MrzLine& line : reading.layout) {
+            cv::Rect line_rect(line.rect.x + rect.x, line.rect.y + rect.y, line.rect.width, line.rect.height);
+            std::string text;
+            float confidence = 0.0f;
+            if (!ocr_->recognize(line_region, line_rect, text, confidence)) {
+                return;
+            }
+            text.erase(std::remove(text.begin(), text.end(), ' '), text.end());
+            reading.scores.emplace_back(text.size(), confidence);
+            reading.lines.push_back(std::move(text));
+        }
+    }
+    if (!extraction::MrzReader::decode(reading)) {
+        return;
+    }
+    
+    // Band pixels to input image pixels
+    auto sourceBox = [&](const cv::Rect& box) {
+        return rectifier_.sourceRect(cv::Rect(box.x + rect.x, box.y + rect.y, box.width, box.height));
+    };
+    
+    ExtractedField raw;
+    raw.name = "mrz";
+    raw.confidence = 1.0f;
+    for (size_t l = 0; l < reading.lines.size(); ++l) {
+        raw.value += (l ? "\n" : "") + reading.lines[l];
+        raw.confidence = std::min(raw.confidence, reading.confidence(static_cast<int>(l), 0,
+                                                                     static_cast<int>(reading.lines[l].size())));
+    }
+    if (!reading.data.valid()) {
+        raw.confidence *= kFailedCheckPenalty;
+    }
+    if (raw.confidence < settings.min_confidence) {
+        return;
+    }
+    raw.box = sourceBox(cv::Rect(reading.layout.front().rect.tl(), reading.layout.back().rect.br()));
+    output.fields.push_back(std::move(raw));
+    
+    for (const extraction::MrzField& mrz_field : reading.data.fields) {
+        if (mrz_field.value.empty()) {
+            continue;
+        }
+        ExtractedField field;
+        field.name = mrz_field.name;
+        field.value = mrz_field.value;
+        field.confidence = reading.confidence(mrz_field.line, mrz_field.begin, mrz_field.length);
+        if (mrz_field.checked) {
+            field.confidence = std::min(field.confidence, reading.confidence(mrz_field.line, mrz_field.check, 1));
+            if (!mrz_field.valid) {
+                field.confidence *= kFailedCheckPenalty;
+            }
+        }
+        if (field.confidence < settings.min_confidence) {
+            continue;
+        }
+        field.box = sourceBox(reading.box(mrz_field.line, mrz_field.begin, mrz_field.length));
+        output.fields.push_back(std::move(field));
+    }
+}
+
+} // namespace core
+} // namespace id_reader
@@ -0,0 +1,160 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_SESSION_H
+#define ID_READER_SESSION_H
+
+#include "id_reader/id_reader.h"
+#include "engine.h"
+#include "stage_timer.h"
+#include "../preprocessing/document_detection/document_detector_base.h"
+#include "../preprocessing/quality/quality_assessor.h"
+#include "../preprocessing/rectification/document_rectifier.h"
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace id_reader {
+namespace core {
+
+struct ExtractedField {
+    std::string name;
+    std::string value;
+    float confidence = 0.0f;
+    cv::Rect box;  // In input image pixels
+};
+
+// Everything one processed image produces, before it is copied out into the
+// C API result structure
+struct ProcessingOutput {
+    preprocessing::DocumentBounds bounds;
+    id_reader_document_type_t document_type = ID_READER_DOCUMENT_UNKNOWN;
+    id_reader_country_t country = ID_READER_COUNTRY_UNKNOWN;
+    float document_type_confidence = 0.0f;
+    float country_confidence = 0.0f;
+    std::vector<ExtractedField> fields;
+    float overall_confidence = 0.0f;
+    bool extracted = false;  // Whether a barcode, the classifier or OCR read anything
+};
+
+// Per-thread processing state bound to a shared engine. A session owns the
+// mutable detector and scratch buffers, so it is cheap to create one per
+// thread and must not itself be used from two threads at once.
+class Session {
+public:
+    explicit Session(std::shared_ptr<const Engine> engine);
+    ~Session();
+    
+    Session(const Session&) = delete;
+    Session& operator=(const Session&) = delete;
+    
+    id_reader_error_t processImage(const id_reader_image_t& image, ProcessingOutput& output);
+    
+    // Ingest, quality gate and detection only: the first half of processImage
+    id_reader_error_t detectDocument(const id_reader_image_t& image, preprocessing::DocumentBounds& bounds);
+    
+    // Downstream stages (classification, field extraction) for a document
+    // already found in `luma`. processImage runs this after detection;
+    // burst capture runs it on the winning frame, and on the next best while
+    // output.extracted comes back false.
+    id_reader_error_t extractDocument(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds,
+                                      ProcessingOutput& output);
+    
+    const std::shared_ptr<const Engine>& engine() const { return engine_; }
+    preprocessing::DocumentDetectorBase& detector() { return *detector_; }
+    
+    // Output record owned by the session, for callers that want to reuse it
+    ProcessingOutput& output() { return output_; }
+    
+    // Luma plane of the most recently ingested image
+    const cv::Mat& luma() const { return luma_; }
+    
+    // Ingest an image into this session's luma buffer
+    id_reader_error_t ingest(const id_reader_image_t& image);
+    
+    // Measure the quality of an image without detecting anything
+    id_reader_error_t assessQuality(const id_reader_image_t& image, preprocessing::QualityReport& report);
+    
+    // Measure the quality of the ingested luma plane
+    const preprocessing::QualityReport& measureQuality();
+    
+    // Quality gate on the ingested luma plane: ID_READER_ERROR_LOW_QUALITY
+    // when the engine enables the gate and the frame fails it. Callers run it
+    // between ingest and detection.
+    id_reader_error_t checkQuality();
+    
+    // Report from the most recent assessment or gate check
+    const preprocessing::QualityReport& quality() const { return quality_; }
+    
+    // Rectified crop of `bounds` from `image` into `output`: from the luma
+    // plane when `color` is false, otherwise from the caller's packed pixels
+    // with their channel layout kept (YUV input is unsupported for color).
+    id_reader_error_t rectify(const id_reader_image_t& image, const preprocessing::DocumentBounds& bounds,
+                              const preprocessing::RectifySettings& settings, bool color, cv::Mat& output);
+    
+    // Crop buffer owned by the session, reused across rectify calls
+    cv::Mat& rectified() { return rectified_; }
+    
+    // Per-stage timings of the most recent processImage call. Only filled in
+    // when the engine has collect_stats set and timing is compiled in.
+    bool collectsStats() const { return collect_stats_; }
+    StageTimings& timings() { return timings_; }
+    const StageTimings& timings() const { return timings_; }
+    
+private:
+    // Decode the AAMVA PDF417 barcode of a North American licence into
+    // `output`. True when it was read, in which case OCR is skipped.
+    bool readBarcode(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds, ProcessingOutput& output);
+    
+    // Fill in document type and country from the engine's model. The
+    // interpreter is built on first use and kept for the session's life.
+    void classify(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds, ProcessingOutput& output);
+    
+    // Rectify the document and read the MRZ band of its format's field
+    // layout: with glyph templates whenever they are available, otherwise
+    // with Tesseract when OCR is enabled
+    void recognizeFields(const cv::Mat& luma, const preprocessing::DocumentBounds& bounds,
+                         ProcessingOutput& output);
+    
+    // Lease an OCR engine on first use and point it at the field crop once
+    // per document. False when Tesseract is unavailable.
+    bool prepareOcr(bool& image_set);
+    
+    // Read the MRZ in `rect` of the field crop: glyph `templates` when there
+    // are any, Tesseract per located line otherwise (if OCR is enabled)
+    void readMrz(const cv::Rect& rect, extraction::MrzFormat format, const extraction::MrzTemplates* templates,
+                 bool& ocr_ready, ProcessingOutput& output);
+    
+    std::shared_ptr<const Engine> engine_;
+    std::unique_ptr<preprocessing::DocumentDetectorBase> detector_;  // Engine chosen by the settings
+    cv::Mat luma_;
+    preprocessing::QualityAssessor quality_assessor_;
+    preprocessing::QualityReport quality_;
+    preprocessing::DocumentRectifier rectifier_;
+    cv::Mat rectified_;
+    cv::Mat field_crop_;  // Rectified luma that field OCR reads
+    extraction::OcrEnginePool::Lease ocr_;  // Taken on first extraction, kept for the session's life
+    extraction::MrzReader mrz_reader_;
+    extraction::MrzReading mrz_reading_;
+    cv::Mat barcode_crop_;  // Rectified luma the barcode reader scans
+    extraction::Pdf417Reader pdf417_reader_;
+    extraction::Pdf417Symbol pdf417_symbol_;
+    std::unique_ptr<classification::DocumentClassifier> classifier_;
+    bool classifier_failed_ = false;  // The model is unusable; do not rebuild the interpreter per call
+    ProcessingOutput output_;
+    StageTimings timings_;
+    bool collect_stats_ = false;
+};
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_SESSION_H
@@ -0,0 +1,82 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_STAGE_TIMER_H
+#define ID_READER_STAGE_TIMER_H
+
+#include <chrono>
+
+namespace id_reader {
+namespace core {
+
+// Wall-clock time spent in each pipeline stage of one processed image
+struct StageTimings {
+    double ingest_ms = 0.0;
+    double quality_ms = 0.0;
+    double preprocess_ms = 0.0;
+    double contours_ms = 0.0;
+    double quad_selection_ms = 0.0;
+    double bounds_ms = 0.0;
+    double confidence_ms = 0.0;
+    double rectify_ms = 0.0;
+    double mrz_ms = 0.0;
+    double barcode_ms = 0.0;
+    double classify_ms = 0.0;
+    double total_ms = 0.0;
+    
+    void reset() { *this = StageTimings(); }
+};
+
+#ifdef ENABLE_STAGE_TIMING
+
+// Adds the lifetime of the enclosing scope to one StageTimings member. A null
+// timings pointer (collection switched off at runtime) costs one branch.
+class ScopedStageTimer {
+public:
+    ScopedStageTimer(StageTimings* timings, double StageTimings::*stage)
+        : timings_(timings), stage_(stage) {
+        if (timings_) {
+            start_ = std::chrono::steady_clock::now();
+        }
+    }
+    
+    ~ScopedStageTimer() {
+        if (timings_) {
+            auto elapsed = std::chrono::steady_clock::now() - start_;
+            timings_->*stage_ += std::chrono::duration<double, std::milli>(elapsed).count();
+        }
+    }
+    
+    ScopedStageTimer(const ScopedStageTimer&) = delete;
+    ScopedStageTimer& operator=(const ScopedStageTimer&) = delete;
+    
+private:
+    StageTimings* timings_;
+    double StageTimings::*stage_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+#define ID_READER_STAGE_TIMER_NAME2(line) id_reader_stage_timer_##line
+#define ID_READER_STAGE_TIMER_NAME(line) ID_READER_STAGE_TIMER_NAME2(line)
+#define ID_READER_TIME_STAGE(timings, stage) \
+    ::id_reader::core::ScopedStageTimer ID_READER_STAGE_TIMER_NAME(__LINE__)( \
+        (timings), &::id_reader::core::StageTimings::stage)
+
+#else
+
+// Timing compiled out: the macro expands to nothing
+#define ID_READER_TIME_STAGE(timings, stage) ((void)0)
+
+#endif // ENABLE_STAGE_TIMING
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_STAGE_TIMER_H
@@ -0,0 +1,130 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "thread_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace id_reader {
+namespace core {
+
+namespace {
+
+// Shared between the caller of parallelFor and the helper tasks it queues.
+// Helpers may start after the caller has already finished every index, so
+// the state is reference counted rather than living on the caller's stack.
+struct ParallelForState {
+    size_t count;
+    std::function<void(size_t, size_t)> fn;
+    std::atomic<size_t> next_index{0};
+    std::atomic<size_t> completed{0};
+    std::mutex mutex;
+    std::condition_variable finished;
+    std::exception_ptr error;
+    
+    void run(size_t worker) {
+        size_t index;
+        while ((index = next_index.fetch_add(1)) < count) {
+            try {
+                fn(index, worker);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+            }
+            
+            if (completed.fetch_add(1) + 1 == count) {
+                std::lock_guard<std::mutex> lock(mutex);
+                finished.notify_all();
+            }
+        }
+    }
+};
+
+} // namespace
+
+ThreadPool::ThreadPool(size_t thread_count) : stopping_(false) {
+    if (thread_count == 0) {
+        thread_count = std::max(1u, std::thread::hardware_concurrency());
+    }
+    
+    workers_.reserve(thread_count);
+    for (size_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    task_available_.notify_all();
+    
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+void ThreadPool::submit(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.push_back(std::move(task));
+    }
+    task_available_.notify_one();
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& fn) {
+    if (count == 0) {
+        return;
+    }
+    
+    auto state = std::make_shared<ParallelForState>();
+    state->count = count;
+    state->fn = fn;
+    
+    // One helper per worker at most; the caller covers the rest itself
+    size_t helpers = std::min(workers_.size(), count - 1);
+    for (size_t i = 0; i < helpers; ++i) {
+        submit([state](size_t worker) { state->run(worker); });
+    }
+    
+    state->run(workers_.size());
+    
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->finished.wait(lock, [&state] { return state->completed.load() == state->count; });
+    
+    if (state->error) {
+        std::rethrow_exception(state->error);
+    }
+}
+
+void ThreadPool::workerLoop(size_t worker) {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            task_available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_ && tasks_.empty()) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        
+        task(worker);
+    }
+}
+
+} // namespace core
+} // namespace id_reader
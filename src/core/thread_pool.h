@@ -0,0 +1,63 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_THREAD_POOL_H
+#define ID_READER_THREAD_POOL_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace id_reader {
+namespace core {
+
+// Fixed-size worker pool. Tasks receive the index of the worker running them
+// so callers can keep per-worker state (detectors, scratch buffers) without
+// locking. Worker indices run from 0 to size() - 1.
+class ThreadPool {
+public:
+    using Task = std::function<void(size_t worker)>;
+    
+    // A thread count of 0 uses the number of hardware threads
+    explicit ThreadPool(size_t thread_count = 0);
+    ~ThreadPool();
+    
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+    
+    size_t size() const { return workers_.size(); }
+    
+    // Queue a task for the next free worker
+    void submit(Task task);
+    
+    // Run fn(index, worker) for every index in [0, count) and wait for all of
+    // them. The calling thread takes part as worker size(), so per-worker
+    // state must have size() + 1 slots; this also means a saturated pool can
+    // never deadlock a caller. The first exception thrown by fn is rethrown.
+    void parallelFor(size_t count, const std::function<void(size_t index, size_t worker)>& fn);
+    
+private:
+    void workerLoop(size_t worker);
+    
+    std::vector<std::thread> workers_;
+    std::deque<Task> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_available_;
+    bool stopping_;
+};
+
+} // namespace core
+} // namespace id_reader
+
+#endif // ID_READER_THREAD_POOL_H
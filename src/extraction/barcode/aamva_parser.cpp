@@ -0,0 +1,231 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "aamva_parser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdlib>
+
+namespace id_reader {
+namespace extraction {
+
+namespace {
+
+enum class ElementKind {
+    Text,
+    Date,
+    Sex
+};
+
+// Data element IDs reported as fields, in output order
+struct ElementName {
+    const char* id;
+    const char* name;
+    ElementKind kind;
+};
+
+const ElementName kElements[] = {
+    {"DAQ", "document_number", ElementKind::Text},
+    {"DCS", "surname", ElementKind::Text},
+    {"DBB", "date_of_birth", ElementKind::Date},
+    {"DBC", "sex", ElementKind::Sex},
+    {"DBA", "date_of_expiry", ElementKind::Date},
+    {"DBD", "date_of_issue", ElementKind::Date},
+    {"DAG", "address", ElementKind::Text},
+    {"DAI", "city", ElementKind::Text},
+    {"DAJ", "jurisdiction", ElementKind::Text},
+    {"DAK", "postal_code", ElementKind::Text},
+    {"DAU", "height", ElementKind::Text},
+    {"DAY", "eye_color", ElementKind::Text},
+    {"DCF", "document_discriminator", ElementKind::Text}
+};
+
+const char* const kCanadianJurisdictions[] = {
+    "AB", "BC", "MB", "NB", "NL", "NS", "NT", "NU", "ON", "PE", "QC", "SK", "YT"
+};
+
+std::string trim(const std::string& text) {
+    size_t begin = text.find_first_not_of(" \r");
+    if (begin == std::string::npos) {
+        return std::string();
+    }
+    size_t end = text.find_last_not_of(" \r");
+    return text.substr(begin, end - begin + 1);
+}
+
+bool digits(const std::string& text, size_t begin, size_t length) {
+    if (begin + length > text.size()) {
+        return false;
+    }
+    for (size_t i = begin; i < begin + length; ++i) {
+        if (!std::isdigit(static_cast<unsigned char>(text[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+int number(const std::string& text, size_t begin, size_t length) {
+    return std::atoi(text.substr(begin, length).c_str());
+}
+
+// Version 1 of the standard and Canadian documents write CCYYMMDD; US
+// documents from version 2 onwards write MMDDCCYY
+std::string normalizeDate(const std::string& value, int version, bool canadian) {
+    if (value.size() != 8 || !digits(value, 0, 8) || version < 2 || canadian) {
+        return value;
+    }
+    return value.substr(4, 4) + value.substr(0, 4);
+}
+
+std::string normalizeSex(const std::string& value) {
+    if (value == "1" || value == "M") {
+        return "M";
+    }
+    if (value == "2" || value == "F") {
+        return "F";
+    }
+    return "X";
+}
+
+const std::string* findElement(const std::vector<AamvaField>& elements, const char* id) {
+    for (const AamvaField& element : elements) {
+        if (element.name == id) {
+            return &element.value;
+        }
+    }
+    return nullptr;
+}
+
+// Split one subfile ("DL" or "ID" followed by elements) at its separators
+void readElements(const std::string& subfile, std::vector<AamvaField>& elements) {
+    size_t position = 2;
+    while (position < subfile.size()) {
+        size_t end = subfile.find_first_of("\n\r", position);
+        if (end == std::string::npos) {
+            end = subfile.size();
+        }
+        std::string element = subfile.substr(position, end - position);
+        if (element.size() > 3 && std::isupper(static_cast<unsigned char>(element[0]))) {
+            elements.push_back({element.substr(0, 3), trim(element.substr(3))});
+        }
+        position = end + 1;
+    }
+}
+
+} // namespace
+
+bool parseAamva(const std::string& payload, AamvaData& data) {
+    data = AamvaData();
+    
+    // "@" LF RS CR, then "ANSI " (version 1 also used "AAMVA") and the issuer
+    size_t header = payload.find("ANSI ");
+    if (header == std::string::npos) {
+        header = payload.find("AAMVA");
+    }
+    if (header == std::string::npos || header > 8 || payload[0] != '@') {
+        return false;
+    }
+    size_t position = header + 5;
+    if (!digits(payload, position, 10)) {
+        return false;
+    }
+    data.issuer_id = payload.substr(position, 6);
+    data.version = number(payload, position + 6, 2);
+    position += 8;
+    if (data.version >= 2) {
+        position += 2;  // Jurisdiction version
+    }
+    int entries = number(payload, position, 2);
+    position += 2;
+    
+    // Subfile directory: type, offset and length of each subfile. Offsets
+    // are from the start of the message, but some issuers count from the
+    // header, so fall back to searching for the subfile type. A directory
+    // that points past the payload only loses its own entry.
+    std::vector<AamvaField> elements;
+    for (int entry = 0; entry < entries && digits(payload, position + 2, 8); ++entry, position += 10) {
+        std::string type = payload.substr(position, 2);
+        if (type != "DL" && type != "ID") {
+            continue;
+        }
+        size_t offset = static_cast<size_t>(number(payload, position + 2, 4));
+        size_t length = static_cast<size_t>(number(payload, position + 6, 4));
+        if (offset + 2 > payload.size() || payload.compare(offset, 2, type) != 0) {
+            offset = payload.find(type, position + 10 * (entries - entry));
+            if (offset == std::string::npos) {
+                continue;
+            }
+        }
+        length = std::min(length, payload.size() - offset);
+        readElements(payload.substr(offset, length), elements);
+        data.drivers_license = data.drivers_license || type == "DL";
+    }
+    if (elements.empty()) {
+        return false;
+    }
+    
+    const std::string* country = findElement(elements, "DCG");
+    const std::string* jurisdiction = findElement(elements, "DAJ");
+    if (country) {
+        data.canadian = *country == "CAN";
+    } else if (jurisdiction) {
+        for (const char* province : kCanadianJurisdictions) {
+            data.canadian = data.canadian || *jurisdiction == province;
+        }
+    }
+    
+    for (const ElementName& element : kElements) {
+        const std::string* value = findElement(elements, element.id);
+        if (!value || value->empty()) {
+            continue;
+        }
+        std::string text = *value;
+        if (element.kind == ElementKind::Date) {
+            text = normalizeDate(text, data.version, data.canadian);
+        } else if (element.kind == ElementKind::Sex) {
+            text = normalizeSex(text);
+        }
+        data.fields.push_back({element.name, text});
+    }
+    
+    // Given names: first and middle (version 2 onwards), or the comma
+    // separated full name of version 1
+    const std::string* first = findElement(elements, "DAC");
+    if (!first) {
+        first = findElement(elements, "DCT");
+    }
+    const std::string* middle = findElement(elements, "DAD");
+    const std::string* full = findElement(elements, "DAA");
+    if (first && !first->empty()) {
+        std::string given = *first;
+        if (middle && !middle->empty() && *middle != "NONE") {
+            given += " " + *middle;
+        }
+        data.fields.push_back({"given_names", given});
+    } else if (full && !findElement(elements, "DCS")) {
+        size_t comma = full->find(',');
+        data.fields.push_back({"surname", full->substr(0, comma)});
+        if (comma != std::string::npos) {
+            std::string given = full->substr(comma + 1);
+            for (char& c : given) {
+                c = c == ',' ? ' ' : c;
+            }
+            data.fields.push_back({"given_names", trim(given)});
+        }
+    }
+    
+    data.fields.push_back({"issuing_country", country ? *country : (data.canadian ? "CAN" : "USA")});
+    return true;
+}
+
+} // namespace extraction
+} // namespace id_reader
@@ -0,0 +1,43 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_AAMVA_PARSER_H
+#define ID_READER_AAMVA_PARSER_H
+
+#include <string>
+#include <vector>
+
+namespace id_reader {
+namespace extraction {
+
+struct AamvaField {
+    std::string name;   // Result field name, matching the MRZ reader's where they overlap
+    std::string value;
+};
+
+// Contents of an AAMVA DL/ID card design standard barcode
+struct AamvaData {
+    std::string issuer_id;       // Six-digit issuer identification number
+    int version = 0;             // AAMVA standard version
+    bool drivers_license = false;  // A DL subfile was present; otherwise an ID card
+    bool canadian = false;
+    std::vector<AamvaField> fields;
+};
+
+// Parse the header, subfile directory and data elements of an AAMVA
+// barcode payload. Dates are returned as YYYYMMDD whichever order the
+// jurisdiction wrote them in; sex as M, F or X. Returns false when `payload`
+// is not an AAMVA message or holds no DL or ID subfile.
+bool parseAamva(const std::string& payload, AamvaData& data);
+
+} // namespace extraction
+} // namespace id_reader
+
+#endif // ID_READER_AAMVA_PARSER_H
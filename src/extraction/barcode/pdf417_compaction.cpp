@@ -0,0 +1,241 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "pdf417_compaction.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace id_reader {
+namespace extraction {
+
+namespace {
+
+// Mode latches and shifts
+constexpr int kTextLatch = 900;
+constexpr int kByteLatch = 901;
+constexpr int kNumericLatch = 902;
+constexpr int kByteShift = 913;
+constexpr int kMacroTerminator = 922;
+constexpr int kMacroOptionalField = 923;
+constexpr int kByteLatchSix = 924;
+constexpr int kEciUserDefined = 925;
+constexpr int kEciGeneralPurpose = 926;
+constexpr int kEciCharset = 927;
+constexpr int kMacroBlock = 928;
+constexpr int kReaderInit = 921;
+
+// Text compaction sub-mode tables (ISO/IEC 15438 table 2)
+constexpr char kMixedChars[] = "0123456789&\r\t,:#-.$/+%*=^";
+constexpr char kPunctChars[] = ";<>@[\\]_`~!\r\t,:\n-.$/\"|*()?{}'";
+
+enum class SubMode {
+    Alpha,
+    Lower,
+    Mixed,
+    Punct
+};
+
+// Sub-mode state carried across text compaction codewords, including into
+// and out of single byte shifts
+struct TextState {
+    SubMode mode = SubMode::Alpha;
+    bool shifted = false;           // Next value read in `shift_mode`, then back to `mode`
+    SubMode shift_mode = SubMode::Alpha;
+};
+
+void decodeTextValue(int value, TextState& state, std::string& data) {
+    SubMode mode = state.shifted ? state.shift_mode : state.mode;
+    bool was_shifted = state.shifted;
+    state.shifted = false;
+    
+    switch (mode) {
+        case SubMode::Alpha:
+            if (value < 26) {
+                data += static_cast<char>('A' + value);
+            } else if (value == 26) {
+                data += ' ';
+            } else if (!was_shifted) {
+                if (value == 27) {
+                    state.mode = SubMode::Lower;
+                } else if (value == 28) {
+                    state.mode = SubMode::Mixed;
+                } else {
+                    state.shifted = true;
+                    state.shift_mode = SubMode::Punct;
+                }
+            }
+            break;
+        case SubMode::Lower:
+            if (value < 26) {
+                data += static_cast<char>('a' + value);
+            } else if (value == 26) {
+                data += ' ';
+            } else if (value == 27) {
+                state.shifted = true;
+                state.shift_mode = SubMode::Alpha;
+            } else if (value == 28) {
+                state.mode = SubMode::Mixed;
+            } else {
+                state.shifted = true;
+                state.shift_mode = SubMode::Punct;
+            }
+            break;
+        case SubMode::Mixed:
+            if (value < 25) {
+                data += kMixedChars[value];
+            } else if (value == 25) {
+                state.mode = SubMode::Punct;
+            } else if (value == 26) {
+                data += ' ';
+            } else if (value == 27) {
+                state.mode = SubMode::Lower;
+            } else if (value == 28) {
+                state.mode = SubMode::Alpha;
+            } else {
+                state.shifted = true;
+                state.shift_mode = SubMode::Punct;
+            }
+            break;
+        case SubMode::Punct:
+            if (value < 29) {
+                data += kPunctChars[value];
+            } else if (!was_shifted) {
+                state.mode = SubMode::Alpha;
+            }
+            break;
+    }
+}
+
+// Base 900 to base 256: five codewords carry six bytes
+void appendByteGroup(const int* codewords, std::string& data) {
+    uint64_t value = 0;
+    for (int i = 0; i < 5; ++i) {
+        value = value * 900 + static_cast<uint64_t>(codewords[i]);
+    }
+    for (int shift = 40; shift >= 0; shift -= 8) {
+        data += static_cast<char>((value >> shift) & 0xff);
+    }
+}
+
+// Base 900 to decimal: up to 15 codewords hold a number whose leading
+// digit 1 is a marker
+bool appendNumericGroup(const std::vector<int>& codewords, size_t begin, size_t end, std::string& data) {
+    std::vector<int> digits;  // Least significant first
+    for (size_t i = begin; i < end; ++i) {
+        int carry = codewords[i];
+        for (int& digit : digits) {
+            int value = digit * 900 + carry;
+            digit = value % 10;
+            carry = value / 10;
+        }
+        while (carry > 0) {
+            digits.push_back(carry % 10);
+            carry /= 10;
+        }
+    }
+    if (digits.empty() || digits.back() != 1) {
+        return false;
+    }
+    for (size_t i = digits.size() - 1; i-- > 0;) {
+        data += static_cast<char>('0' + digits[i]);
+    }
+    return true;
+}
+
+} // namespace
+
+bool decodePdf417Data(const std::vector<int>& codewords, std::string& data) {
+    data.clear();
+    if (codewords.empty() || codewords[0] < 1 || codewords[0] > static_cast<int>(codewords.size())) {
+        return false;
+    }
+    const size_t end = static_cast<size_t>(codewords[0]);
+    
+    TextState text;
+    int mode = kTextLatch;
+    size_t i = 1;
+    while (i < end) {
+        int codeword = codewords[i];
+        if (codeword >= kTextLatch) {
+            ++i;
+            switch (codeword) {
+                case kTextLatch:
+                    text = TextState();
+                    mode = kTextLatch;
+                    break;
+                case kByteLatch:
+                case kByteLatchSix:
+                case kNumericLatch:
+                    mode = codeword;
+                    break;
+                case kByteShift:
+                    if (i < end) {
+                        data += static_cast<char>(codewords[i++] & 0xff);
+                    }
+                    break;
+                case kEciCharset:
+                case kEciUserDefined:
+                case kReaderInit:
+                    i += codeword == kReaderInit ? 0 : 1;
+                    break;
+                case kEciGeneralPurpose:
+                    i += 2;
+                    break;
+                case kMacroBlock:
+                case kMacroOptionalField:
+                case kMacroTerminator:
+                    return true;  // Macro PDF417 control data follows the message
+                default:
+                    return false;
+            }
+            continue;
+        }
+        
+        // The run of data codewords up to the next latch or shift
+        size_t run_end = i;
+        while (run_end < end && codewords[run_end] < kTextLatch) {
+            ++run_end;
+        }
+        
+        switch (mode) {
+            case kTextLatch:
+                for (; i < run_end; ++i) {
+                    decodeTextValue(codewords[i] / 30, text, data);
+                    decodeTextValue(codewords[i] % 30, text, data);
+                }
+                break;
+            case kByteLatch:
+            case kByteLatchSix: {
+                // Under 901 the last one to five codewords carry a byte each
+                size_t count = run_end - i;
+                size_t singles = mode == kByteLatch ? (count - 1) % 5 + 1 : count % 5;
+                for (; i + 5 <= run_end - singles; i += 5) {
+                    appendByteGroup(&codewords[i], data);
+                }
+                for (; i < run_end; ++i) {
+                    data += static_cast<char>(codewords[i] & 0xff);
+                }
+                break;
+            }
+            case kNumericLatch:
+                for (; i < run_end; i = std::min(i + 15, run_end)) {
+                    if (!appendNumericGroup(codewords, i, std::min(i + 15, run_end), data)) {
+                        return false;
+                    }
+                }
+                break;
+        }
+    }
+    return true;
+}
+
+} // namespace extraction
+} // namespace id_reader
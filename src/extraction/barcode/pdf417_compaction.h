@@ -0,0 +1,30 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_PDF417_COMPACTION_H
+#define ID_READER_PDF417_COMPACTION_H
+
+#include <string>
+#include <vector>
+
+namespace id_reader {
+namespace extraction {
+
+// Turn error-corrected PDF417 data codewords (starting with the symbol
+// length descriptor, without the error correction codewords) into the
+// bytes they encode, following the text, byte and numeric compaction modes
+// of ISO/IEC 15438. Macro PDF417 control blocks end the data. Returns false
+// for a malformed codeword stream.
+bool decodePdf417Data(const std::vector<int>& codewords, std::string& data);
+
+} // namespace extraction
+} // namespace id_reader
+
+#endif // ID_READER_PDF417_COMPACTION_H
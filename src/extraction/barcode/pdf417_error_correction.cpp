@@ -0,0 +1,189 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "pdf417_error_correction.h"
+#include <array>
+#include <cstddef>
+
+namespace id_reader {
+namespace extraction {
+
+namespace {
+
+constexpr int kModulus = kPdf417CodewordCount;
+
+// Arithmetic in the prime field GF(929) through exponent and log tables of
+// the generator 3
+class Gf929 {
+public:
+    Gf929() {
+        int value = 1;
+        for (int i = 0; i < kModulus - 1; ++i) {
+            exp_[i] = value;
+            log_[value] = i;
+            value = value * 3 % kModulus;
+        }
+        exp_[kModulus - 1] = 1;
+    }
+    
+    static int add(int a, int b) { return (a + b) % kModulus; }
+    static int subtract(int a, int b) { return (a - b + kModulus) % kModulus; }
+    
+    int multiply(int a, int b) const {
+        if (a == 0 || b == 0) {
+            return 0;
+        }
+        return exp_[(log_[a] + log_[b]) % (kModulus - 1)];
+    }
+    
+    int inverse(int a) const { return exp_[(kModulus - 1 - log_[a]) % (kModulus - 1)]; }
+    
+    // 3^power for any integer power
+    int power(int power) const {
+        power %= kModulus - 1;
+        return exp_[power < 0 ? power + kModulus - 1 : power];
+    }
+    
+private:
+    std::array<int, kModulus> exp_{};
+    std::array<int, kModulus> log_{};
+};
+
+const Gf929& field() {
+    static const Gf929 instance;
+    return instance;
+}
+
+// Evaluate a polynomial stored lowest degree first
+int evaluate(const std::vector<int>& polynomial, int x) {
+    const Gf929& gf = field();
+    int result = 0;
+    for (size_t i = polynomial.size(); i-- > 0;) {
+        result = Gf929::add(gf.multiply(result, x), polynomial[i]);
+    }
+    return result;
+}
+
+} // namespace
+
+int correctPdf417Errors(std::vector<int>& codewords, int ec_count, const std::vector<int>& erasures) {
+    const Gf929& gf = field();
+    const int n = static_cast<int>(codewords.size());
+    const int erasure_count = static_cast<int>(erasures.size());
+    if (ec_count < 2 || ec_count >= n || erasure_count > ec_count) {
+        return -1;
+    }
+    
+    // Codeword j is the coefficient of x^(n - 1 - j); a valid symbol has
+    // roots 3^1 .. 3^ec_count
+    std::vector<int> received(n);
+    for (int j = 0; j < n; ++j) {
+        if (codewords[j] < 0 || codewords[j] >= kModulus) {
+            return -1;
+        }
+        received[n - 1 - j] = codewords[j];
+    }
+    std::vector<int> syndromes(ec_count);
+    bool clean = true;
+    for (int i = 0; i < ec_count; ++i) {
+        syndromes[i] = evaluate(received, gf.power(i + 1));
+        clean = clean && syndromes[i] == 0;
+    }
+    if (clean) {
+        return 0;
+    }
+    
+    // Erasure locator: product of (1 - X x) over the known positions X
+    std::vector<int> locator = {1};
+    for (int j : erasures) {
+        if (j < 0 || j >= n) {
+            return -1;
+        }
+        int location = gf.power(n - 1 - j);
+        locator.push_back(0);
+        for (size_t i = locator.size() - 1; i > 0; --i) {
+            locator[i] = Gf929::subtract(locator[i], gf.multiply(location, locator[i - 1]));
+        }
+    }
+    
+    // Berlekamp-Massey seeded with the erasure locator: each unknown error
+    // costs two syndromes, each erasure one
+    std::vector<int> previous = locator;
+    int length = erasure_count;
+    for (int step = erasure_count; step < ec_count; ++step) {
+        int discrepancy = 0;
+        for (int i = 0; i < static_cast<int>(locator.size()) && i <= step; ++i) {
+            discrepancy = Gf929::add(discrepancy, gf.multiply(locator[i], syndromes[step - i]));
+        }
+        previous.insert(previous.begin(), 0);
+        if (discrepancy == 0) {
+            continue;
+        }
+        
+        std::vector<int> updated = locator;
+        if (updated.size() < previous.size()) {
+            updated.resize(previous.size(), 0);
+        }
+        for (size_t i = 0; i < previous.size(); ++i) {
+            updated[i] = Gf929::subtract(updated[i], gf.multiply(discrepancy, previous[i]));
+        }
+        if (2 * length <= step + erasure_count) {
+            int scale = gf.inverse(discrepancy);
+            previous.resize(locator.size());
+            for (size_t i = 0; i < locator.size(); ++i) {
+                previous[i] = gf.multiply(scale, locator[i]);
+            }
+            length = step + 1 - length + erasure_count;
+        }
+        locator = updated;
+    }
+    for (size_t i = length + 1; i < locator.size(); ++i) {
+        if (locator[i] != 0) {
+            return -1;
+        }
+    }
+    locator.resize(length + 1, 0);
+    if (length == 0 || 2 * length - erasure_count > ec_count) {
+        return -1;
+    }
+    
+    // Error evaluator: syndrome polynomial times locator, mod x^ec_count
+    std::vector<int> evaluator(ec_count, 0);
+    for (int i = 0; i < ec_count; ++i) {
+        for (int j = 0; j <= length && i + j < ec_count; ++j) {
+            evaluator[i + j] = Gf929::add(evaluator[i + j], gf.multiply(syndromes[i], locator[j]));
+        }
+    }
+    std::vector<int> derivative(length, 0);
+    for (int i = 1; i <= length; ++i) {
+        derivative[i - 1] = gf.multiply(locator[i], i % kModulus);
+    }
+    
+    // Chien search for the error positions, Forney for their values
+    int corrected = 0;
+    for (int degree = 0; degree < n; ++degree) {
+        int inverse_location = gf.power(-degree);
+        if (evaluate(locator, inverse_location) != 0) {
+            continue;
+        }
+        int denominator = evaluate(derivative, inverse_location);
+        if (denominator == 0) {
+            return -1;
+        }
+        int magnitude = Gf929::subtract(0, gf.multiply(evaluate(evaluator, inverse_location), gf.inverse(denominator)));
+        int& codeword = codewords[n - 1 - degree];
+        codeword = Gf929::subtract(codeword, magnitude);
+        ++corrected;
+    }
+    return corrected == length ? corrected : -1;
+}
+
+} // namespace extraction
+} // namespace id_reader
@@ -0,0 +1,34 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_PDF417_ERROR_CORRECTION_H
+#define ID_READER_PDF417_ERROR_CORRECTION_H
+
+#include <vector>
+
+namespace id_reader {
+namespace extraction {
+
+// Number of PDF417 codeword values; error correction works in GF(929)
+constexpr int kPdf417CodewordCount = 929;
+
+// Reed-Solomon error correction for PDF417 over GF(929). `codewords` is the
+// whole symbol in transmission order, its last `ec_count` codewords being
+// error correction (2^(level + 1) for error correction level 0-8).
+// `erasures` are the indices of codewords known to be unreadable, whatever
+// value they hold. Corrects e wrong codewords and the erasures in place as
+// long as 2e + erasures <= ec_count. Returns the number corrected, erasures
+// included, or -1 when the symbol is beyond repair.
+int correctPdf417Errors(std::vector<int>& codewords, int ec_count, const std::vector<int>& erasures = {});
+
+} // namespace extraction
+} // namespace id_reader
+
+#endif // ID_READER_PDF417_ERROR_CORRECTION_H
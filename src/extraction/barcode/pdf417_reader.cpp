@@ -0,0 +1,380 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "pdf417_reader.h"
+#include "pdf417_compaction.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+namespace id_reader {
+namespace extraction {
+
+namespace {
+
+constexpr int kCodewordModules = 17;
+constexpr int kCodewordElements = 8;
+constexpr int kMaxCodewordElement = 6;
+constexpr int kPatternCount = 1 << kCodewordModules;
+
+// Guard patterns as module widths, bar first
+constexpr int kStartPattern[] = {8, 1, 1, 1, 1, 1, 1, 3};
+constexpr int kStopPattern[] = {7, 1, 1, 3, 1, 1, 1, 2, 1};
+constexpr int kStopModules = 18;
+
+// A codeword may differ in width from the last one by this fraction
+constexpr double kWidthTolerance = 0.25;
+
+// Scan line spacing in pixels; symbol rows are at least three modules tall
+constexpr int kScanStep = 2;
+
+// Round run widths to `count` elements that add up to `modules`, each at
+// least 1 and at most `max_element` modules
+bool quantize(const int* runs, int count, int modules, int max_element, int* elements) {
+    int total = 0;
+    for (int i = 0; i < count; ++i) {
+        total += runs[i];
+    }
+    if (total < modules) {
+        return false;
+    }
+    
+    double exact[9];
+    int sum = 0;
+    for (int i = 0; i < count; ++i) {
+        exact[i] = static_cast<double>(runs[i]) * modules / total;
+        elements[i] = std::max(1, static_cast<int>(std::lround(exact[i])));
+        sum += elements[i];
+    }
+    // Fix rounding drift on the elements that were rounded furthest
+    while (sum != modules) {
+        int step = sum > modules ? -1 : 1;
+        int best = -1;
+        double best_error = -1.0;
+        for (int i = 0; i < count; ++i) {
+            double error = step * (exact[i] - elements[i]);
+            if ((step > 0 || elements[i] > 1) && error > best_error) {
+                best = i;
+                best_error = error;
+            }
+        }
+        if (best < 0) {
+            return false;
+        }
+        elements[best] += step;
+        sum += step;
+    }
+    for (int i = 0; i < count; ++i) {
+        if (elements[i] > max_element) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool matches(const int* runs, const int* pattern, int count, int modules) {
+    int elements[9];
+    if (!quantize(runs, count, modules, modules, elements)) {
+        return false;
+    }
+    return std::equal(elements, elements + count, pattern);
+}
+
+// (b1 - b2 + b3 - b4 + 9) mod 9 over the bar widths: 0, 3 or 6
+int clusterOf(const int* elements) {
+    return (elements[0] - elements[2] + elements[4] - elements[6] + 9) % 9;
+}
+
+// Split a 17-bit pattern into its element widths
+bool patternElements(int pattern, int* elements) {
+    if (pattern < (1 << (kCodewordModules - 1)) || pattern >= kPatternCount) {
+        return false;
+    }
+    int count = 0;
+    int bit = kCodewordModules - 1;
+    while (bit >= 0) {
+        int value = (pattern >> bit) & 1;
+        int width = 0;
+        for (; bit >= 0 && ((pattern >> bit) & 1) == value; --bit) {
+            ++width;
+        }
+        if (count == kCodewordElements || width > kMaxCodewordElement || value != (count % 2 == 0 ? 1 : 0)) {
+            return false;
+        }
+        elements[count++] = width;
+    }
+    return count == kCodewordElements;
+}
+
+int patternOf(const int* elements) {
+    int pattern = 0;
+    for (int i = 0; i < kCodewordElements; ++i) {
+        for (int module = 0; module < elements[i]; ++module) {
+            pattern = (pattern << 1) | (i % 2 == 0 ? 1 : 0);
+        }
+    }
+    return pattern;
+}
+
+// The row of a symbol a codeword of `cluster` belongs to: the one nearest
+// `row` with that cluster, so a slightly skewed scan line that drifts into
+// a neighbouring row still places its codewords correctly
+int rowFor(int row, int cluster) {
+    for (int offset : {0, -1, 1}) {
+        if (row + offset >= 0 && (row + offset) % 3 == cluster / 3) {
+            return row + offset;
+        }
+    }
+    return row;
+}
+
+template <size_t N>
+int vote(const std::array<int, N>& votes) {
+    auto best = std::max_element(votes.begin(), votes.end());
+    return *best > 0 ? static_cast<int>(best - votes.begin()) : -1;
+}
+
+} // namespace
+
+bool readPdf417Patterns(const std::string& path, std::vector<uint32_t>& patterns) {
+    patterns.clear();
+    std::ifstream file(path);
+    if (!file) {
+        return false;
+    }
+    
+    std::string token;
+    while (file >> token) {
+        if (token[0] == '#') {
+            std::getline(file, token);
+            continue;
+        }
+        char* end = nullptr;
+        unsigned long pattern = std::strtoul(token.c_str(), &end, 0);
+        if (*end != '\0' || pattern >= static_cast<unsigned long>(kPatternCount)) {
+            return false;
+        }
+        patterns.push_back(static_cast<uint32_t>(pattern));
+    }
+    return patterns.size() == 3 * kPdf417CodewordCount;
+}
+
+bool Pdf417Codebook::load(const std::string& path) {
+    std::vector<uint32_t> patterns;
+    return readPdf417Patterns(path, patterns) && loadPatterns(patterns.data(), patterns.size());
+}
+
+bool Pdf417Codebook::loadPatterns(const uint32_t* patterns, size_t count) {
+    if (count != 3 * kPdf417CodewordCount) {
+        return false;
+    }
+    
+    std::vector<int16_t> codewords(kPatternCount, -1);
+    for (size_t index = 0; index < count; ++index) {
+        int pattern = static_cast<int>(patterns[index] & (kPatternCount - 1));
+        int elements[kCodewordElements];
+        if (patterns[index] >= kPatternCount || !patternElements(pattern, elements) ||
+            clusterOf(elements) != 3 * static_cast<int>(index / kPdf417CodewordCount)) {
+            return false;
+        }
+        codewords[pattern] = static_cast<int16_t>(index % kPdf417CodewordCount);
+    }
+    codewords_.swap(codewords);
+    return true;
+}
+
+float Pdf417Symbol::confidence() const {
+    int capacity = 2 << error_level;  // Error correction codewords
+    int cost = 2 * (corrected - erased) + erased;
+    return 1.0f - 0.5f * std::min(1.0f, static_cast<float>(cost) / capacity);
+}
+
+bool Pdf417Reader::Observation::operator<(const Observation& other) const {
+    if (row != other.row) {
+        return row < other.row;
+    }
+    if (column != other.column) {
+        return column < other.column;
+    }
+    return codeword < other.codeword;
+}
+
+bool Pdf417Reader::read(const cv::Mat& image, const Pdf417Codebook& codebook, Pdf417Symbol& symbol) {
+    if (image.empty() || codebook.empty()) {
+        return false;
+    }
+    cv::threshold(image, binary_, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
+    if (scan(binary_, codebook, symbol)) {
+        return true;
+    }
+    
+    // Upside down: the start pattern is then at the right end of each row
+    cv::rotate(binary_, rotated_, cv::ROTATE_180);
+    if (!scan(rotated_, codebook, symbol)) {
+        return false;
+    }
+    symbol.box = cv::Rect(image.cols - symbol.box.x - symbol.box.width, image.rows - symbol.box.y - symbol.box.height,
+                          symbol.box.width, symbol.box.height);
+    return true;
+}
+
+bool Pdf417Reader::scan(const cv::Mat& binary, const Pdf417Codebook& codebook, Pdf417Symbol& symbol) {
+    observations_.clear();
+    row_group_votes_.fill(0);
+    row_info_votes_.fill(0);
+    column_votes_.fill(0);
+    cv::Rect box;
+    
+    for (int y = kScanStep / 2; y < binary.rows; y += kScanStep) {
+        // Run lengths of the row, starting with a (possibly empty) space
+        const uchar* pixels = binary.ptr<uchar>(y);
+        runs_.clear();
+        positions_.clear();
+        runs_.push_back(0);
+        positions_.push_back(0);
+        uchar color = 0;
+        for (int x = 0; x < binary.cols; ++x) {
+            if (pixels[x] != color) {
+                color = pixels[x];
+                runs_.push_back(0);
+                positions_.push_back(x);
+            }
+            ++runs_.back();
+        }
+        readLine(y, codebook, box);
+    }
+    
+    symbol.box = box;
+    return assemble(symbol);
+}
+
+void Pdf417Reader::readLine(int y, const Pdf417Codebook& codebook, cv::Rect& box) {
+    const int count = static_cast<int>(runs_.size());
+    for (int start = 1; start + kCodewordElements <= count; start += 2) {
+        if (!matches(&runs_[start], kStartPattern, kCodewordElements, kCodewordModules)) {
+            continue;
+        }
+        
+        // Codewords up to the stop pattern or the first unreadable one
+        line_.clear();
+        double width = positions_[start + kCodewordElements] - positions_[start];
+        bool stopped = false;
+        int next = start + kCodewordElements;
+        for (; next + kCodewordElements <= count; next += kCodewordElements) {
+            if (next + 9 <= count && matches(&runs_[next], kStopPattern, 9, kStopModules)) {
+                stopped = true;
+                break;
+            }
+            const int last = next + kCodewordElements - 1;
+            double codeword_width = positions_[last] + runs_[last] - positions_[next];
+            int elements[kCodewordElements];
+            if (std::abs(codeword_width - width) > kWidthTolerance * width ||
+                !quantize(&runs_[next], kCodewordElements, kCodewordModules, kMaxCodewordElement, elements)) {
+                break;
+            }
+            int value = codebook.codeword(patternOf(elements));
+            if (value < 0) {
+                break;
+            }
+            line_.push_back({clusterOf(elements), value});
+            width = codeword_width;
+        }
+        if (line_.size() < 2) {
+            continue;
+        }
+        
+        // Left row indicator: row group, cluster-dependent symbol metadata
+        const LineCodeword& left = line_.front();
+        int row = (left.value / 30) * 3 + left.cluster / 3;
+        int info = left.value % 30;
+        (left.cluster == 0 ? row_group_votes_ : left.cluster == 3 ? row_info_votes_ : column_votes_)[info]++;
+        
+        size_t data_end = line_.size();
+        if (stopped && line_.size() >= 3 && line_.back().cluster == left.cluster &&
+            line_.back().value / 30 == left.value / 30) {
+            // The right indicator carries the same three values in another order
+            const LineCodeword& right = line_.back();
+            info = right.value % 30;
+            (right.cluster == 0 ? column_votes_ : right.cluster == 3 ? row_group_votes_ : row_info_votes_)[info]++;
+            --data_end;
+        }
+        for (size_t i = 1; i < data_end; ++i) {
+            observations_.push_back({rowFor(row, line_[i].cluster), static_cast<int>(i) - 1, line_[i].value});
+        }
+        
+        int right_edge = positions_[next - 1] + runs_[next - 1];
+        box |= cv::Rect(positions_[start], y, right_edge - positions_[start], kScanStep);
+        start = next - 2;  // Resume at the bar after what was read
+    }
+}
+
+bool Pdf417Reader::assemble(Pdf417Symbol& symbol) {
+    int row_group = vote(row_group_votes_);
+    int row_info = vote(row_info_votes_);
+    int column = vote(column_votes_);
+    if (row_group < 0 || row_info < 0 || column < 0 || observations_.empty()) {
+        return false;
+    }
+    symbol.rows = row_group * 3 + row_info % 3 + 1;
+    symbol.error_level = row_info / 3;
+    symbol.columns = column + 1;
+    const int total = symbol.rows * symbol.columns;
+    const int ec_count = 2 << symbol.error_level;
+    if (symbol.rows < 3 || symbol.error_level > 8 || total > kPdf417CodewordCount - 1 || total <= ec_count) {
+        return false;
+    }
+    
+    // Majority codeword per cell; cells no scan line read are erasures,
+    // which cost error correction half what an unknown error does
+    codewords_.assign(total, -1);
+    std::sort(observations_.begin(), observations_.end());
+    auto sameCell = [](const Observation& a, const Observation& b) {
+        return a.row == b.row && a.column == b.column;
+    };
+    int best_votes = 0;
+    for (size_t i = 0, j; i < observations_.size(); i = j) {
+        const Observation& first = observations_[i];
+        for (j = i + 1; j < observations_.size() && sameCell(first, observations_[j]) &&
+                        observations_[j].codeword == first.codeword; ++j) {
+        }
+        if (i == 0 || !sameCell(first, observations_[i - 1])) {
+            best_votes = 0;
+        }
+        int votes = static_cast<int>(j - i);
+        if (first.row < symbol.rows && first.column < symbol.columns && votes > best_votes) {
+            codewords_[first.row * symbol.columns + first.column] = first.codeword;
+            best_votes = votes;
+        }
+    }
+    
+    erasures_.clear();
+    for (int i = 0; i < total; ++i) {
+        if (codewords_[i] < 0) {
+            erasures_.push_back(i);
+            codewords_[i] = 0;
+        }
+    }
+    // Keep two codewords spare for error detection: with none left, any
+    // fill of the erasures would pass as corrected
+    if (static_cast<int>(erasures_.size()) > ec_count - 2) {
+        return false;
+    }
+    symbol.corrected = correctPdf417Errors(codewords_, ec_count, erasures_);
+    if (symbol.corrected < 0) {
+        return false;
+    }
+    symbol.erased = symbol.corrected > 0 ? static_cast<int>(erasures_.size()) : 0;
+    codewords_.resize(total - ec_count);
+    return decodePdf417Data(codewords_, symbol.data);
+}
+
+} // namespace extraction
+} // namespace id_reader
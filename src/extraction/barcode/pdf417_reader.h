@@ -0,0 +1,133 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_PDF417_READER_H
+#define ID_READER_PDF417_READER_H
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "pdf417_error_correction.h"
+
+namespace id_reader {
+namespace extraction {
+
+struct BarcodeSettings {
+    bool enabled = true;
+    std::string codebook_path;  // PDF417 codeword table; empty: barcodes are not read
+    double dpi = 400.0;         // Resolution of the rectified crop the barcode is read from
+};
+
+// The PDF417 codeword table: for each of the clusters 0, 3 and 6, the bar
+// and space pattern of every codeword value. Built once and shared
+// read-only between sessions.
+class Pdf417Codebook {
+public:
+    // Read 3 x 929 whitespace-separated patterns (decimal or 0x hex):
+    // clusters 0, 3 and 6 in turn, each in codeword order. A pattern is the
+    // codeword's 17 modules, first module in bit 16, bar modules set. Lines
+    // starting with '#' are comments.
+    bool load(const std::string& path);
+    
+    // Build from 3 x 929 patterns in the same order
+    bool loadPatterns(const uint32_t* patterns, size_t count);
+    
+    bool empty() const { return codewords_.empty(); }
+    
+    // Codeword value of a 17-module pattern, or -1 when it is not one
+    int codeword(int pattern) const { return codewords_[pattern]; }
+    
+private:
+    std::vector<int16_t> codewords_;  // Indexed by pattern
+};
+
+// Read the patterns of a codeword table file in the format Pdf417Codebook::load
+// takes, without building the lookup table
+bool readPdf417Patterns(const std::string& path, std::vector<uint32_t>& patterns);
+
+// One decoded symbol
+struct Pdf417Symbol {
+    int rows = 0;
+    int columns = 0;      // Data columns, without the row indicators
+    int error_level = 0;
+    int corrected = 0;    // Codewords repaired by error correction
+    int erased = 0;       // Of which no scan line read
+    std::string data;     // Message bytes
+    cv::Rect box;         // In pixels of the image read
+    
+    // 1 for a clean read, falling to 0.5 as the error correction budget
+    // is used up (an erasure costs half what an error does)
+    float confidence() const;
+};
+
+// Locates and decodes a PDF417 symbol in an 8-bit image whose rows run
+// roughly along the symbol's rows (a rectified card, either way up). Scan
+// lines are split into bar/space runs; each one that starts with the start
+// pattern is read codeword by codeword, its left (and right) row indicator
+// telling which symbol row it crossed. Codewords are voted per row and
+// column across all scan lines, missing ones are passed to Reed-Solomon
+// error correction as erasures, and the result goes through the compaction
+// modes. Owns scratch buffers, so one per session.
+class Pdf417Reader {
+public:
+    Pdf417Reader() = default;
+    
+    Pdf417Reader(const Pdf417Reader&) = delete;
+    Pdf417Reader& operator=(const Pdf417Reader&) = delete;
+    
+    // False when no symbol is found or it cannot be decoded
+    bool read(const cv::Mat& image, const Pdf417Codebook& codebook, Pdf417Symbol& symbol);
+    
+private:
+    struct Observation {
+        int row;
+        int column;
+        int codeword;
+        
+        bool operator<(const Observation& other) const;
+    };
+    
+    struct LineCodeword {
+        int cluster;
+        int value;
+    };
+    
+    bool scan(const cv::Mat& binary, const Pdf417Codebook& codebook, Pdf417Symbol& symbol);
+    
+    // Read the scan line in runs_ from every start pattern on it, recording
+    // its codewords; extends `box` over what was read
+    void readLine(int y, const Pdf417Codebook& codebook, cv::Rect& box);
+    
+    // Most frequent codeword per row and column, then error correction
+    bool assemble(Pdf417Symbol& symbol);
+    
+    cv::Mat binary_;   // Bars are 255
+    cv::Mat rotated_;
+    std::vector<int> runs_;       // Widths, alternating space and bar, space first
+    std::vector<int> positions_;  // Start column of each run
+    std::vector<LineCodeword> line_;
+    std::vector<Observation> observations_;
+    std::vector<int> codewords_;
+    std::vector<int> erasures_;   // Cells of codewords_ no scan line read
+    // Row indicator votes: (rows - 1) / 3, error level * 3 + (rows - 1) % 3,
+    // and data columns - 1
+    std::array<int, 30> row_group_votes_;
+    std::array<int, 30> row_info_votes_;
+    std::array<int, 30> column_votes_;
+};
+
+} // namespace extraction
+} // namespace id_reader
+
+#endif // ID_READER_PDF417_READER_H
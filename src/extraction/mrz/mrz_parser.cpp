@@ -0,0 +1,236 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "mrz_parser.h"
+
+namespace id_reader {
+namespace extraction {
+
+const char kMrzAlphabet[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ<";
+
+namespace {
+
+// Positions of one field within an MRZ line; check < 0 for unchecked fields
+struct FieldSpec {
+    const char* name;
+    int line;
+    int begin;
+    int length;
+    int check;
+};
+
+// ICAO 9303 part 4 (TD3) and part 5 (TD1). Names are split separately.
+const FieldSpec kTd3Fields[] = {
+    {"document_code", 0, 0, 2, -1},
+    {"issuing_country", 0, 2, 3, -1},
+    {"document_number", 1, 0, 9, 9},
+    {"nationality", 1, 10, 3, -1},
+    {"date_of_birth", 1, 13, 6, 19},
+    {"sex", 1, 20, 1, -1},
+    {"date_of_expiry", 1, 21, 6, 27},
+    {"personal_number", 1, 28, 14, 42}
+};
+
+const FieldSpec kTd1Fields[] = {
+    {"document_code", 0, 0, 2, -1},
+    {"issuing_country", 0, 2, 3, -1},
+    {"document_number", 0, 5, 9, 14},
+    {"optional_data", 0, 15, 15, -1},
+    {"date_of_birth", 1, 0, 6, 6},
+    {"sex", 1, 7, 1, -1},
+    {"date_of_expiry", 1, 8, 6, 14},
+    {"nationality", 1, 15, 3, -1},
+    {"optional_data_2", 1, 18, 11, -1}
+};
+
+// Characters covered by the composite check digit, as {line, begin, length}
+struct Span {
+    int line;
+    int begin;
+    int length;
+};
+
+const Span kTd3Composite[] = {{1, 0, 10}, {1, 13, 7}, {1, 21, 22}};
+const Span kTd3CompositeDigit = {1, 43, 1};
+const Span kTd1Composite[] = {{0, 5, 25}, {1, 0, 7}, {1, 8, 7}, {1, 18, 11}};
+const Span kTd1CompositeDigit = {1, 29, 1};
+
+int charValue(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A' + 10;
+    }
+    return c == '<' ? 0 : -1;
+}
+
+// Fillers become spaces; leading and trailing ones are dropped
+std::string cleanValue(const std::string& raw) {
+    std::string value;
+    for (char c : raw) {
+        value += c == '<' ? ' ' : c;
+    }
+    size_t end = value.find_last_not_of(' ');
+    if (end == std::string::npos) {
+        return std::string();
+    }
+    value.erase(end + 1);
+    return value.substr(value.find_first_not_of(' '));
+}
+
+bool checkMatches(const std::string& text, size_t begin, size_t length, char check) {
+    int expected = mrzCheckDigit(text, begin, length);
+    return expected >= 0 && expected == charValue(check);
+}
+
+template <size_t N>
+void addFields(const FieldSpec (&specs)[N], const std::vector<std::string>& lines, MrzData& data) {
+    for (const FieldSpec& spec : specs) {
+        MrzField field;
+        field.name = spec.name;
+        field.line = spec.line;
+        field.begin = spec.begin;
+        field.length = spec.length;
+        field.value = cleanValue(lines[spec.line].substr(spec.begin, spec.length));
+        if (spec.check >= 0) {
+            field.checked = true;
+            field.check = spec.check;
+            field.valid = checkMatches(lines[spec.line], spec.begin, spec.length, lines[spec.line][spec.check]);
+        }
+        data.fields.push_back(field);
+    }
+}
+
+// Primary identifier (surname) and secondary identifier (given names) are
+// separated by a double filler
+void addNames(const std::string& line, int line_index, int begin, MrzData& data) {
+    std::string names = line.substr(begin);
+    size_t separator = names.find("<<");
+    
+    MrzField surname;
+    surname.name = "surname";
+    surname.line = line_index;
+    surname.begin = begin;
+    surname.length = static_cast<int>(separator == std::string::npos ? names.size() : separator);
+    surname.value = cleanValue(names.substr(0, surname.length));
+    data.fields.push_back(surname);
+    
+    if (separator != std::string::npos) {
+        MrzField given;
+        given.name = "given_names";
+        given.line = line_index;
+        given.begin = begin + static_cast<int>(separator) + 2;
+        given.length = static_cast<int>(names.size() - separator - 2);
+        given.value = cleanValue(names.substr(separator + 2));
+        data.fields.push_back(given);
+    }
+}
+
+template <size_t N>
+bool compositeMatches(const Span (&spans)[N], const Span& digit, const std::vector<std::string>& lines) {
+    std::string covered;
+    for (const Span& span : spans) {
+        covered += lines[span.line].substr(span.begin, span.length);
+    }
+    return checkMatches(covered, 0, covered.size(), lines[digit.line][digit.begin]);
+}
+
+} // namespace
+
+int mrzLineCount(MrzFormat format) {
+    return format == MrzFormat::Td3 ? 2 : 3;
+}
+
+int mrzLineLength(MrzFormat format) {
+    return format == MrzFormat::Td3 ? 44 : 30;
+}
+
+MrzCharClass mrzCharClass(MrzFormat format, int line, int index) {
+    if (format == MrzFormat::Td3) {
+        if (line == 0) {
+            return MrzCharClass::Letter;
+        }
+        if (index == 9 || (index >= 13 && index <= 19) || (index >= 21 && index <= 27) || index == 43) {
+            return MrzCharClass::Digit;
+        }
+        if ((index >= 10 && index <= 12) || index == 20) {
+            return MrzCharClass::Letter;
+        }
+        return MrzCharClass::Any;
+    }
+    
+    if (line == 0) {
+        return index < 5 ? MrzCharClass::Letter : MrzCharClass::Any;
+    }
+    if (line == 1) {
+        if (index == 7 || (index >= 15 && index <= 17)) {
+            return MrzCharClass::Letter;
+        }
+        return index < 15 || index == 29 ? MrzCharClass::Digit : MrzCharClass::Any;
+    }
+    return MrzCharClass::Letter;
+}
+
+int mrzCheckDigit(const std::string& text, size_t begin, size_t length) {
+    static const int kWeights[3] = {7, 3, 1};
+    if (begin + length > text.size()) {
+        return -1;
+    }
+    
+    int sum = 0;
+    for (size_t i = 0; i < length; ++i) {
+        int value = charValue(text[begin + i]);
+        if (value < 0) {
+            return -1;
+        }
+        sum += value * kWeights[i % 3];
+    }
+    return sum % 10;
+}
+
+bool MrzData::valid() const {
+    if (!composite_valid) {
+        return false;
+    }
+    for (const MrzField& field : fields) {
+        if (!field.valid) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool parseMrz(MrzFormat format, const std::vector<std::string>& lines, MrzData& data) {
+    data = MrzData();
+    data.format = format;
+    if (static_cast<int>(lines.size()) != mrzLineCount(format)) {
+        return false;
+    }
+    for (const std::string& line : lines) {
+        if (static_cast<int>(line.size()) != mrzLineLength(format)) {
+            return false;
+        }
+    }
+    
+    if (format == MrzFormat::Td3) {
+        addFields(kTd3Fields, lines, data);
+        addNames(lines[0], 0, 5, data);
+        data.composite_valid = compositeMatches(kTd3Composite, kTd3CompositeDigit, lines);
+    } else {
+        addFields(kTd1Fields, lines, data);
+        addNames(lines[2], 2, 0, data);
+        data.composite_valid = compositeMatches(kTd1Composite, kTd1CompositeDigit, lines);
+    }
+    return true;
+}
+
+} // namespace extraction
+} // namespace id_reader
@@ -0,0 +1,72 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_MRZ_PARSER_H
+#define ID_READER_MRZ_PARSER_H
+
+#include <string>
+#include <vector>
+
+namespace id_reader {
+namespace extraction {
+
+// ICAO 9303 machine readable zone layouts
+enum class MrzFormat {
+    Td1,  // ID-1 cards: 3 lines of 30 characters
+    Td3   // Passports: 2 lines of 44 characters
+};
+
+// Every MRZ character; glyph templates follow this order
+extern const char kMrzAlphabet[];
+constexpr int kMrzAlphabetSize = 37;
+
+// Characters a position may hold, from the format's field definitions
+enum class MrzCharClass {
+    Digit,
+    Letter,  // A-Z and the < filler
+    Any
+};
+
+int mrzLineCount(MrzFormat format);
+int mrzLineLength(MrzFormat format);
+MrzCharClass mrzCharClass(MrzFormat format, int line, int index);
+
+// ICAO 9303 check digit (weights 7, 3, 1) over `length` characters of
+// `text` from `begin`, or -1 if one of them is not an MRZ character
+int mrzCheckDigit(const std::string& text, size_t begin, size_t length);
+
+struct MrzField {
+    std::string name;   // Result field name, e.g. "date_of_birth"
+    std::string value;  // Fillers turned into spaces and trimmed
+    int line = 0;       // Source characters, for confidence and boxes
+    int begin = 0;
+    int length = 0;
+    bool checked = false;  // Covered by its own check digit
+    int check = -1;        // Index of that check digit within the line
+    bool valid = true;     // That check digit matched
+};
+
+struct MrzData {
+    MrzFormat format = MrzFormat::Td3;
+    std::vector<MrzField> fields;
+    bool composite_valid = false;
+    
+    // Every check digit, including the composite one, matched
+    bool valid() const;
+};
+
+// Split MRZ lines into fields and validate the check digits. Returns false
+// when the line count or lengths do not fit `format`.
+bool parseMrz(MrzFormat format, const std::vector<std::string>& lines, MrzData& data);
+
+} // namespace extraction
+} // namespace id_reader
+
+#endif // ID_READER_MRZ_PARSER_H
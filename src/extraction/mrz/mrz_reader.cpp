@@ -0,0 +1,395 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "mrz_reader.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace id_reader {
+namespace extraction {
+
+namespace {
+
+// Glyphs are compared at this size, aspect ratio kept
+constexpr int kGlyphWidth = 20;
+constexpr int kGlyphHeight = 28;
+
+// ICAO 9303 prints the MRZ at 10 characters per inch
+constexpr double kCharactersPerInch = 10.0;
+
+// OCR-B glyphs take up about this much of their cell's width
+constexpr double kInkFraction = 0.6;
+
+// How far the measured pitch may stray from the nominal one, to absorb
+// rectification scale error
+constexpr double kPitchTolerance = 0.15;
+
+// A row belongs to a text line when its ink reaches this fraction of the
+// densest row
+constexpr double kLineThreshold = 0.15;
+
+// Row gaps shorter than this (in pitches) are inside a line; runs shorter
+// than kMinLineHeight are noise
+constexpr double kLineGapFactor = 0.15;
+constexpr double kMinLineHeight = 0.4;
+
+// Largest score drop accepted when swapping in a runner-up to satisfy a
+// check digit
+constexpr float kMaxRepairLoss = 0.25f;
+
+// Scale the ink of a binary cell into the glyph box, centered and with its
+// aspect ratio kept, as a zero-mean unit-length CV_32F image. Returns false
+// for a cell without ink.
+bool normalizeGlyph(const cv::Mat& cell, cv::Mat& resized, cv::Mat& glyph) {
+    cv::Rect ink = cv::boundingRect(cell);
+    if (ink.empty()) {
+        return false;
+    }
+    
+    double scale = std::min(static_cast<double>(kGlyphWidth) / ink.width,
+                            static_cast<double>(kGlyphHeight) / ink.height);
+    cv::Size size(std::min(kGlyphWidth, std::max(1, static_cast<int>(std::lround(ink.width * scale)))),
+                  std::min(kGlyphHeight, std::max(1, static_cast<int>(std::lround(ink.height * scale)))));
+    cv::resize(cell(ink), resized, size, 0, 0, cv::INTER_AREA);
+    
+    glyph.create(kGlyphHeight, kGlyphWidth, CV_32F);
+    glyph.setTo(cv::Scalar(0));
+    cv::Mat placed = glyph(cv::Rect((kGlyphWidth - size.width) / 2, (kGlyphHeight - size.height) / 2,
+                                    size.width, size.height));
+    resized.convertTo(placed, CV_32F);
+    
+    glyph -= cv::mean(glyph)[0];
+    double norm = cv::norm(glyph);
+    if (norm < std::numeric_limits<double>::epsilon()) {
+        return false;
+    }
+    glyph /= norm;
+    return true;
+}
+
+// Dark-on-light 8-bit image to a binary ink mask
+void binarize(const cv::Mat& image, cv::Mat& blurred, cv::Mat& binary) {
+    cv::GaussianBlur(image, blurred, cv::Size(3, 3), 0);
+    cv::threshold(blurred, binary, 0, 255, cv::THRESH_BINARY_INV | cv::THRESH_OTSU);
+}
+
+// Column near `nominal` with the least ink, preferring the nearest on ties
+int cutColumn(const int* columns, int count, double nominal, double radius) {
+    int begin = std::max(0, static_cast<int>(std::lround(nominal - radius)));
+    int end = std::min(count - 1, static_cast<int>(std::lround(nominal + radius)));
+    if (begin > end) {
+        return std::min(count, std::max(0, static_cast<int>(std::lround(nominal))));
+    }
+    int best = begin;
+    for (int x = begin + 1; x <= end; ++x) {
+        if (columns[x] < columns[best] ||
+            (columns[x] == columns[best] && std::abs(x - nominal) < std::abs(best - nominal))) {
+            best = x;
+        }
+    }
+    return best;
+}
+
+// Whether `field` of the current lines passes its check digit
+bool fieldValid(const MrzReading& reading, size_t field) {
+    MrzData data;
+    return parseMrz(reading.format, reading.lines, data) && data.fields[field].valid;
+}
+
+} // namespace
+
+bool MrzTemplates::loadStrip(const cv::Mat& strip) {
+    templates_.release();
+    if (strip.empty()) {
+        return false;
+    }
+    
+    cv::Mat gray;
+    if (strip.channels() == 1) {
+        gray = strip;
+    } else {
+        cv::cvtColor(strip, gray, strip.channels() == 4 ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+    }
+    cv::Mat blurred, binary, resized, glyph;
+    binarize(gray, blurred, binary);
+    
+    cv::Mat templates(kMrzAlphabetSize, kGlyphWidth * kGlyphHeight, CV_32F);
+    const double cell_width = static_cast<double>(binary.cols) / kMrzAlphabetSize;
+    for (int i = 0; i < kMrzAlphabetSize; ++i) {
+        int x0 = static_cast<int>(std::lround(i * cell_width));
+        int x1 = static_cast<int>(std::lround((i + 1) * cell_width));
+        if (!normalizeGlyph(binary(cv::Rect(x0, 0, x1 - x0, binary.rows)), resized, glyph)) {
+            return false;
+        }
+        glyph.reshape(1, 1).copyTo(templates.row(i));
+    }
+    templates_ = templates;
+    return true;
+}
+
+bool MrzTemplates::load(const std::string& path) {
+    return loadStrip(cv::imread(path, cv::IMREAD_GRAYSCALE));
+}
+
+bool MrzTemplates::loadMatrix(const cv::Mat& templates) {
+    if (templates.rows != kMrzAlphabetSize || templates.cols != kGlyphWidth * kGlyphHeight ||
+        templates.type() != CV_32F) {
+        templates_.release();
+        return false;
+    }
+    templates_ = templates;
+    return true;
+}
+
+float MrzReading::confidence(int line, int begin, int length) const {
+    if (line >= static_cast<int>(scores.size())) {
+        return 0.0f;
+    }
+    const std::vector<float>& line_scores = scores[line];
+    float lowest = 1.0f;
+    for (int i = begin; i < begin + length && i < static_cast<int>(line_scores.size()); ++i) {
+        lowest = std::min(lowest, line_scores[i]);
+    }
+    return lowest;
+}
+
+cv::Rect MrzReading::box(int line, int begin, int length) const {
+    if (line >= static_cast<int>(layout.size()) || length <= 0) {
+        return cv::Rect();
+    }
+    const std::vector<cv::Rect>& cells = layout[line].cells;
+    int first = std::min(begin, static_cast<int>(cells.size()) - 1);
+    int last = std::min(begin + length, static_cast<int>(cells.size())) - 1;
+    return cv::Rect(cells[first].tl(), cells[last].br());
+}
+
+bool MrzReader::segment(const cv::Mat& band, MrzFormat format, double dpi, MrzReading& reading) {
+    reading = MrzReading();
+    reading.format = format;
+    if (band.empty() || band.type() != CV_8UC1 || dpi <= 0.0) {
+        return false;
+    }
+    
+    binarize(band, blurred_, binary_);
+    cv::reduce(binary_, row_profile_, 1, cv::REDUCE_SUM, CV_32S);
+    const int* rows = row_profile_.ptr<int>();
+    const int height = binary_.rows;
+    const int peak = *std::max_element(rows, rows + height);
+    if (peak == 0) {
+        return false;
+    }
+    
+    // Bands of rows dense enough to be text, bridging thin gaps
+    const double pitch = dpi / kCharactersPerInch;
+    const int threshold = std::max(1, static_cast<int>(peak * kLineThreshold));
+    std::vector<cv::Range> runs;
+    for (int y = 0; y < height;) {
+        if (rows[y] < threshold) {
+            ++y;
+            continue;
+        }
+        int start = y;
+        while (y < height && rows[y] >= threshold) {
+            ++y;
+        }
+        if (!runs.empty() && start - runs.back().end < pitch * kLineGapFactor) {
+            runs.back().end = y;
+        } else {
+            runs.push_back(cv::Range(start, y));
+        }
+    }
+    runs.erase(std::remove_if(runs.begin(), runs.end(), [&](const cv::Range& run) {
+        return run.size() < pitch * kMinLineHeight;
+    }), runs.end());
+    
+    // The MRZ is the bottom of the document; anything above is visual zone
+    const int line_count = mrzLineCount(format);
+    const int length = mrzLineLength(format);
+    if (static_cast<int>(runs.size()) < line_count) {
+        return false;
+    }
+    runs.erase(runs.begin(), runs.end() - line_count);
+    
+    for (const cv::Range& run : runs) {
+        // Grow to every row with ink, so ascenders and the < fillers'
+        // tips stay in the line
+        int y0 = run.start;
+        int y1 = run.end;
+        while (y0 > 0 && rows[y0 - 1] > 0) {
+            --y0;
+        }
+        while (y1 < height && rows[y1] > 0) {
+            ++y1;
+        }
+        
+        cv::reduce(binary_.rowRange(y0, y1), column_profile_, 0, cv::REDUCE_SUM, CV_32S);
+        const int* columns = column_profile_.ptr<int>();
+        const int width = binary_.cols;
+        int left = 0;
+        while (left < width && columns[left] == 0) {
+            ++left;
+        }
+        int right = width;
+        while (right > left && columns[right - 1] == 0) {
+            --right;
+        }
+        if (left >= right) {
+            return false;
+        }
+        
+        // Every position holds a glyph (fillers included), so the inked
+        // span is length - 1 pitches plus one glyph
+        double line_pitch = (right - left) / (length - 1.0 + kInkFraction);
+        line_pitch = std::min(pitch * (1.0 + kPitchTolerance), std::max(pitch * (1.0 - kPitchTolerance), line_pitch));
+        const double start = left - line_pitch * (1.0 - kInkFraction) / 2.0;
+        
+        // Cut between cells at the emptiest column near each nominal boundary
+        MrzLine line;
+        int previous = std::max(0, static_cast<int>(std::lround(start)));
+        for (int i = 1; i <= length; ++i) {
+            double nominal = start + i * line_pitch;
+            int cut = i == length ? std::min(width, static_cast<int>(std::lround(nominal)))
+                                  : cutColumn(columns, width, nominal, line_pitch / 4.0);
+            cut = std::max(cut, previous);
+            line.cells.push_back(cv::Rect(previous, y0, cut - previous, y1 - y0));
+            previous = cut;
+        }
+        line.rect = cv::Rect(line.cells.front().tl(), line.cells.back().br());
+        reading.layout.push_back(line);
+    }
+    return true;
+}
+
+void MrzReader::classify(const MrzTemplates& templates, MrzReading& reading) {
+    reading.lines.clear();
+    reading.scores.clear();
+    reading.alternates.clear();
+    reading.alternate_scores.clear();
+    if (templates.empty()) {
+        return;
+    }
+    
+    const cv::Mat& matrix = templates.templates();
+    const int dimension = matrix.cols;
+    for (size_t l = 0; l < reading.layout.size(); ++l) {
+        const std::vector<cv::Rect>& cells = reading.layout[l].cells;
+        std::string text(cells.size(), '<');
+        std::string alternate(cells.size(), '<');
+        std::vector<float> scores(cells.size(), 0.0f);
+        std::vector<float> alternate_scores(cells.size(), 0.0f);
+        
+        for (size_t i = 0; i < cells.size(); ++i) {
+            if (cells[i].empty() || !normalizeGlyph(binary_(cells[i]), resized_, glyph_)) {
+                continue;
+            }
+            
+            // Digits come first in the alphabet, then letters and the filler
+            int first = 0;
+            int last = kMrzAlphabetSize;
+            switch (mrzCharClass(reading.format, static_cast<int>(l), static_cast<int>(i))) {
+                case MrzCharClass::Digit:
+                    last = 10;
+                    break;
+                case MrzCharClass::Letter:
+                    first = 10;
+                    break;
+                case MrzCharClass::Any:
+                    break;
+            }
+            
+            const float* g = glyph_.ptr<float>();
+            float best = -1.0f;
+            float second = -1.0f;
+            int best_index = first;
+            int second_index = first;
+            for (int k = first; k < last; ++k) {
+                const float* t = matrix.ptr<float>(k);
+                float score = 0.0f;
+                for (int j = 0; j < dimension; ++j) {
+                    score += t[j] * g[j];
+                }
+                if (score > best) {
+                    second = best;
+                    second_index = best_index;
+                    best = score;
+                    best_index = k;
+                } else if (score > second) {
+                    second = score;
+                    second_index = k;
+                }
+            }
+            text[i] = kMrzAlphabet[best_index];
+            scores[i] = std::max(0.0f, best);
+            alternate[i] = kMrzAlphabet[second_index];
+            alternate_scores[i] = std::max(0.0f, second);
+        }
+        
+        reading.lines.push_back(text);
+        reading.scores.push_back(scores);
+        reading.alternates.push_back(alternate);
+        reading.alternate_scores.push_back(alternate_scores);
+    }
+}
+
+bool MrzReader::decode(MrzReading& reading) {
+    if (!parseMrz(reading.format, reading.lines, reading.data)) {
+        return false;
+    }
+    if (reading.alternates.size() != reading.lines.size()) {
+        return true;
+    }
+    
+    // A failed check digit usually means one confusable glyph (0/O, 5/S,
+    // 8/B): take the cheapest single runner-up swap that fixes it
+    bool repaired = false;
+    const std::vector<MrzField> fields = reading.data.fields;
+    for (size_t f = 0; f < fields.size(); ++f) {
+        const MrzField& field = fields[f];
+        if (!field.checked || field.valid) {
+            continue;
+        }
+        
+        std::string& line = reading.lines[field.line];
+        const std::string& alternates = reading.alternates[field.line];
+        std::vector<float>& scores = reading.scores[field.line];
+        const std::vector<float>& alternate_scores = reading.alternate_scores[field.line];
+        int best_position = -1;
+        float best_loss = kMaxRepairLoss;
+        for (int p = field.begin; p <= field.begin + field.length; ++p) {
+            int position = p < field.begin + field.length ? p : field.check;
+            char original = line[position];
+            if (alternates[position] == original) {
+                continue;
+            }
+            float loss = scores[position] - alternate_scores[position];
+            if (loss >= best_loss) {
+                continue;
+            }
+            line[position] = alternates[position];
+            if (fieldValid(reading, f)) {
+                best_position = position;
+                best_loss = loss;
+            }
+            line[position] = original;
+        }
+        
+        if (best_position >= 0) {
+            line[best_position] = alternates[best_position];
+            scores[best_position] = alternate_scores[best_position];
+            repaired = true;
+        }
+    }
+    
+    return !repaired || parseMrz(reading.format, reading.lines, reading.data);
+}
+
+} // namespace extraction
+} // namespace id_reader
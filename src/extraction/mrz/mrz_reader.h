@@ -0,0 +1,108 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_MRZ_READER_H
+#define ID_READER_MRZ_READER_H
+
+#include <opencv2/opencv.hpp>
+#include <string>
+#include <vector>
+
+#include "mrz_parser.h"
+
+namespace id_reader {
+namespace extraction {
+
+// Normalized glyph images for the MRZ alphabet, one row per character of
+// kMrzAlphabet. Built once and shared read-only between sessions.
+class MrzTemplates {
+public:
+    // Build from one row of the 37 characters in kMrzAlphabet order, dark on
+    // light, each centered in an equal-width cell (for example OCR-B
+    // rendered at any size)
+    bool loadStrip(const cv::Mat& strip);
+    
+    // Read such a strip from an image file
+    bool load(const std::string& path);
+    
+    // Use templates() as built by the above, for example from an asset
+    // bundle. The matrix is referenced, not copied.
+    bool loadMatrix(const cv::Mat& templates);
+    
+    bool empty() const { return templates_.empty(); }
+    const cv::Mat& templates() const { return templates_; }
+    
+private:
+    cv::Mat templates_;  // kMrzAlphabetSize x glyph pixels, CV_32F
+};
+
+// Geometry of one MRZ text line, in pixels of the band it was found in
+struct MrzLine {
+    cv::Rect rect;
+    std::vector<cv::Rect> cells;  // One per character position
+};
+
+// One MRZ read: geometry from segmentation, then text (from templates or
+// any other recognizer) and finally the parsed fields
+struct MrzReading {
+    MrzFormat format = MrzFormat::Td3;
+    std::vector<MrzLine> layout;
+    std::vector<std::string> lines;
+    std::vector<std::vector<float>> scores;  // Per character, 0-1
+    std::vector<std::string> alternates;     // Runner-up per character, empty when unknown
+    std::vector<std::vector<float>> alternate_scores;
+    MrzData data;
+    
+    // Lowest character score of the `length` characters from `begin`
+    float confidence(int line, int begin, int length) const;
+    
+    // Bounding box of those characters, in band pixels
+    cv::Rect box(int line, int begin, int length) const;
+};
+
+// Reads the machine readable zone of a rectified document. MRZ text is
+// OCR-B at a fixed pitch of 10 characters per inch in a known number of
+// lines, so instead of general OCR the band is split into lines by its row
+// profile and into character cells by the pitch, and every cell is matched
+// against the glyph templates. Owns scratch buffers, so one per session.
+class MrzReader {
+public:
+    MrzReader() = default;
+    
+    MrzReader(const MrzReader&) = delete;
+    MrzReader& operator=(const MrzReader&) = delete;
+    
+    // Find the format's text lines at the bottom of `band`, an 8-bit crop
+    // at `dpi`, and cut them into cells. Returns false when fewer lines are
+    // found.
+    bool segment(const cv::Mat& band, MrzFormat format, double dpi, MrzReading& reading);
+    
+    // Classify every cell of the band last passed to segment, keeping each
+    // position to the characters its field allows
+    void classify(const MrzTemplates& templates, MrzReading& reading);
+    
+    // Parse reading.lines, first replacing characters with their runner-up
+    // where that is what makes a field's check digit match. Returns false
+    // when the lines do not fit the format.
+    static bool decode(MrzReading& reading);
+    
+private:
+    cv::Mat blurred_;
+    cv::Mat binary_;   // Ink is 255
+    cv::Mat row_profile_;
+    cv::Mat column_profile_;
+    cv::Mat resized_;
+    cv::Mat glyph_;
+};
+
+} // namespace extraction
+} // namespace id_reader
+
+#endif // ID_READER_MRZ_READER_H
@@ -0,0 +1,47 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "field_layout.h"
+#include "../mrz/mrz_parser.h"
+#include <cmath>
+
+namespace id_reader {
+namespace extraction {
+
+namespace {
+
+// ICAO 9303 part 5, TD1: three MRZ lines in the bottom 17.9 mm of 53.98 mm
+const std::vector<FieldRegion> kId1Layout = {
+    {"mrz", cv::Rect2f(0.02f, 0.64f, 0.96f, 0.35f), kMrzAlphabet, false}
+};
+
+// ICAO 9303 part 4, TD3: two MRZ lines in the bottom 23.2 mm of 88 mm
+const std::vector<FieldRegion> kTd3Layout = {
+    {"mrz", cv::Rect2f(0.02f, 0.72f, 0.96f, 0.27f), kMrzAlphabet, false}
+};
+
+} // namespace
+
+const std::vector<FieldRegion>& fieldLayout(preprocessing::DocumentFormat format) {
+    return format == preprocessing::DocumentFormat::Td3 ? kTd3Layout : kId1Layout;
+}
+
+cv::Rect fieldRect(const FieldRegion& region, const cv::Size& size) {
+    const float w = static_cast<float>(size.width);
+    const float h = static_cast<float>(size.height);
+    cv::Rect rect(static_cast<int>(std::lround(region.area.x * w)),
+                  static_cast<int>(std::lround(region.area.y * h)),
+                  static_cast<int>(std::lround(region.area.width * w)),
+                  static_cast<int>(std::lround(region.area.height * h)));
+    return rect & cv::Rect(0, 0, size.width, size.height);
+}
+
+} // namespace extraction
+} // namespace id_reader
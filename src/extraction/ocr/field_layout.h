@@ -0,0 +1,42 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_FIELD_LAYOUT_H
+#define ID_READER_FIELD_LAYOUT_H
+
+#include <opencv2/opencv.hpp>
+#include <vector>
+
+#include "../../preprocessing/rectification/document_rectifier.h"
+
+namespace id_reader {
+namespace extraction {
+
+// One region of a rectified document that is read as text
+struct FieldRegion {
+    const char* name;       // Field name reported in the result
+    cv::Rect2f area;        // Fraction of the rectified crop's width and height
+    const char* whitelist;  // Characters OCR may return, or nullptr for any
+    bool single_line;       // One text line rather than a block
+};
+
+// Regions to recognize on a landscape crop of `format` (Id1 or Td3). Until
+// per-country layouts exist the only one is the ICAO 9303 machine readable
+// zone, which sits in the same place on every compliant document and goes
+// to the dedicated MRZ reader.
+const std::vector<FieldRegion>& fieldLayout(preprocessing::DocumentFormat format);
+
+// `region.area` in pixels of a crop of `size`, clipped to the crop
+cv::Rect fieldRect(const FieldRegion& region, const cv::Size& size);
+
+} // namespace extraction
+} // namespace id_reader
+
+#endif // ID_READER_FIELD_LAYOUT_H
@@ -0,0 +1,169 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "ocr_engine_pool.h"
+#include <tesseract/baseapi.h>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace id_reader {
+namespace extraction {
+
+namespace {
+
+// Strip the line break Tesseract appends, and stray blanks around the text
+void trim(std::string& text) {
+    const char* blanks = " \t\r\n";
+    size_t end = text.find_last_not_of(blanks);
+    if (end == std::string::npos) {
+        text.clear();
+        return;
+    }
+    text.erase(end + 1);
+    text.erase(0, text.find_first_not_of(blanks));
+}
+
+} // namespace
+
+OcrEngine::OcrEngine() : api_(std::make_unique<tesseract::TessBaseAPI>()) {}
+
+OcrEngine::~OcrEngine() {
+    api_->End();
+}
+
+std::unique_ptr<OcrEngine> OcrEngine::create(const OcrSettings& settings) {
+    std::unique_ptr<OcrEngine> engine(new OcrEngine());
+    
+    // ID fields are names, numbers and codes rather than words, so skip
+    // loading the dictionaries: faster to initialize and no word bias
+    std::vector<std::string> names = {"load_system_dawg", "load_freq_dawg"};
+    std::vector<std::string> values = {"0", "0"};
+    const char* datapath = settings.tessdata_path.empty() ? nullptr : settings.tessdata_path.c_str();
+    if (engine->api_->Init(datapath, settings.language.c_str(), tesseract::OEM_LSTM_ONLY,
+                           nullptr, 0, &names, &values, false) != 0) {
+        return nullptr;
+    }
+    return engine;
+}
+
+void OcrEngine::setImage(const cv::Mat& image, double dpi) {
+    CV_Assert(image.type() == CV_8UC1);
+    api_->SetImage(image.data, image.cols, image.rows, 1, static_cast<int>(image.step));
+    api_->SetSourceResolution(static_cast<int>(std::lround(dpi)));
+}
+
+bool OcrEngine::recognize(const FieldRegion& region, const cv::Rect& rect, std::string& text, float& confidence) {
+    text.clear();
+    confidence = 0.0f;
+    if (rect.empty()) {
+        return false;
+    }
+    
+    api_->SetVariable("tessedit_char_whitelist", region.whitelist ? region.whitelist : "");
+    api_->SetPageSegMode(region.single_line ? tesseract::PSM_SINGLE_LINE : tesseract::PSM_SINGLE_BLOCK);
+    api_->SetRectangle(rect.x, rect.y, rect.width, rect.height);
+    
+    std::unique_ptr<char[]> utf8(api_->GetUTF8Text());
+    if (!utf8) {
+        return false;
+    }
+    text = utf8.get();
+    trim(text);
+    if (text.empty()) {
+        return false;
+    }
+    confidence = std::max(0, api_->MeanTextConf()) / 100.0f;
+    return true;
+}
+
+OcrEnginePool::Lease::Lease(OcrEnginePool* pool, std::unique_ptr<OcrEngine> engine)
+    : pool_(pool), engine_(std::move(engine)) {}
+
+OcrEnginePool::Lease::Lease(Lease&& other) noexcept
+    : pool_(other.pool_), engine_(std::move(other.engine_)) {
+    other.pool_ = nullptr;
+}
+
+OcrEnginePool::Lease& OcrEnginePool::Lease::operator=(Lease&& other) noexcept {
+    if (this != &other) {
+        if (engine_) {
+            pool_->release(std::move(engine_));
+        }
+        pool_ = other.pool_;
+        engine_ = std::move(other.engine_);
+        other.pool_ = nullptr;
+    }
+    return *this;
+}
+
+OcrEnginePool::Lease::~Lease() {
+    if (engine_) {
+        pool_->release(std::move(engine_));
+    }
+}
+
+OcrEnginePool::OcrEnginePool(const OcrSettings& settings, size_t warm_engines)
+    : settings_(settings), warming_(warm_engines) {
+    for (size_t i = 0; i < warm_engines; ++i) {
+        warm_up_threads_.emplace_back(&OcrEnginePool::warmUp, this);
+    }
+}
+
+OcrEnginePool::~OcrEnginePool() {
+    for (auto& thread : warm_up_threads_) {
+        thread.join();
+    }
+}
+
+void OcrEnginePool::warmUp() {
+    std::unique_ptr<OcrEngine> engine = OcrEngine::create(settings_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (engine) {
+        idle_.push_back(std::move(engine));
+    } else {
+        failed_ = true;
+    }
+    --warming_;
+    warmed_.notify_all();
+}
+
+OcrEnginePool::Lease OcrEnginePool::acquire() {
+    {
+        // An engine already warming up is ready sooner than a new one
+        std::unique_lock<std::mutex> lock(mutex_);
+        warmed_.wait(lock, [this] { return failed_ || !idle_.empty() || warming_ == 0; });
+        if (failed_) {
+            return Lease();
+        }
+        if (!idle_.empty()) {
+            std::unique_ptr<OcrEngine> engine = std::move(idle_.back());
+            idle_.pop_back();
+            return Lease(this, std::move(engine));
+        }
+    }
+    
+    // Initialize outside the lock so other sessions can still take idle engines
+    std::unique_ptr<OcrEngine> engine = OcrEngine::create(settings_);
+    if (!engine) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed_ = true;
+        return Lease();
+    }
+    return Lease(this, std::move(engine));
+}
+
+void OcrEnginePool::release(std::unique_ptr<OcrEngine> engine) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.push_back(std::move(engine));
+}
+
+} // namespace extraction
+} // namespace id_reader
@@ -0,0 +1,125 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_OCR_ENGINE_POOL_H
+#define ID_READER_OCR_ENGINE_POOL_H
+
+#include <opencv2/opencv.hpp>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "field_layout.h"
+
+namespace tesseract {
+class TessBaseAPI;
+}
+
+namespace id_reader {
+namespace extraction {
+
+struct OcrSettings {
+    bool enabled = false;
+    std::string tessdata_path;    // Empty: Tesseract's own lookup (TESSDATA_PREFIX)
+    std::string language = "eng";
+    double dpi = 300.0;           // Resolution of the rectified crop OCR reads
+    float min_confidence = 0.5f;  // 0-1; fields below this are left out
+    std::string mrz_templates_path;  // MRZ glyph strip; empty: Tesseract reads the MRZ lines
+};
+
+// One initialized Tesseract instance. Not thread-safe: an engine belongs to
+// one session at a time, handed out by OcrEnginePool.
+class OcrEngine {
+public:
+    ~OcrEngine();
+    
+    OcrEngine(const OcrEngine&) = delete;
+    OcrEngine& operator=(const OcrEngine&) = delete;
+    
+    // Load the language model; nullptr when Tesseract cannot initialize
+    static std::unique_ptr<OcrEngine> create(const OcrSettings& settings);
+    
+    // Point Tesseract at an 8-bit single-channel image without copying it.
+    // `image` must stay alive and unchanged while fields are recognized.
+    void setImage(const cv::Mat& image, double dpi);
+    
+    // Recognize `rect` of the current image. `confidence` is 0-1. Returns
+    // false when nothing was read.
+    bool recognize(const FieldRegion& region, const cv::Rect& rect, std::string& text, float& confidence);
+    
+private:
+    OcrEngine();
+    
+    std::unique_ptr<tesseract::TessBaseAPI> api_;
+};
+
+// Hands out initialized OCR engines. Initialization loads the language model
+// and takes hundreds of milliseconds, so a number of engines are initialized
+// in the background as soon as the pool exists, and engines are recycled:
+// beyond the warm ones the pool grows on demand to the number of sessions
+// that hold one at a time, which is one per worker thread. Thread-safe.
+class OcrEnginePool {
+public:
+    // Returns its engine to the pool on destruction
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(Lease&& other) noexcept;
+        Lease& operator=(Lease&& other) noexcept;
+        ~Lease();
+        
+        OcrEngine* operator->() const { return engine_.get(); }
+        explicit operator bool() const { return engine_ != nullptr; }
+        
+    private:
+        friend class OcrEnginePool;
+        Lease(OcrEnginePool* pool, std::unique_ptr<OcrEngine> engine);
+        
+        OcrEnginePool* pool_ = nullptr;
+        std::unique_ptr<OcrEngine> engine_;
+    };
+    
+    // Starts initializing `warm_engines` engines in parallel
+    OcrEnginePool(const OcrSettings& settings, size_t warm_engines);
+    // Waits for warm-up still in progress
+    ~OcrEnginePool();
+    
+    OcrEnginePool(const OcrEnginePool&) = delete;
+    OcrEnginePool& operator=(const OcrEnginePool&) = delete;
+    
+    // An idle engine, one still warming up once it is ready, or a newly
+    // initialized one. The lease is empty when Tesseract failed to
+    // initialize; that is remembered, so later calls return at once instead
+    // of retrying.
+    Lease acquire();
+    
+private:
+    void release(std::unique_ptr<OcrEngine> engine);
+    
+    // Initialize one engine into the idle list
+    void warmUp();
+    
+    OcrSettings settings_;
+    std::mutex mutex_;
+    std::condition_variable warmed_;
+    std::vector<std::unique_ptr<OcrEngine>> idle_;
+    size_t warming_ = 0;  // Engines still initializing in warm-up threads
+    bool failed_ = false;
+    std::vector<std::thread> warm_up_threads_;
+};
+
+} // namespace extraction
+} // namespace id_reader
+
+#endif // ID_READER_OCR_ENGINE_POOL_H
@@ -13,130 +13,198 @@
 #include <opencv2/imgproc.hpp>
 #include <vector>
 #include <algorithm>
+#include <array>
+#include <cmath>
 
 namespace id_reader {
 namespace preprocessing {
 
-DocumentDetector::DocumentDetector() {
-    // Default parameters for document detection
-    canny_threshold1_ = 50;
-    canny_threshold2_ = 150;
-    min_contour_area_ = 10000;
-    max_contour_area_ = 500000;
-    approx_epsilon_factor_ = 0.02;
+// Default parameters for document detection live in DetectorSettings
+DocumentDetector::DocumentDetector() : DocumentDetector(DetectorSettings()) {}
+
+DocumentDetector::DocumentDetector(const DetectorSettings& settings) : DocumentDetectorBase(settings) {
+    // Built once; preprocessImage used to recreate it on every call
+    morph_kernel_ = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
 }
 
 DocumentDetector::~DocumentDetector() = default;
 
-bool DocumentDetector::detectDocument(const cv::Mat& input_image, DocumentBounds& bounds) {
-    if (input_image.empty()) {
-        return false;
+bool DocumentDetector::detectDocumentInRegion(const cv::Mat& input_image, const cv::Rect& roi, DocumentBounds& bounds) {
+    cv::Rect region;
+    cv::Mat working;
+    double scale = 0.0;
+    {
+        ID_READER_TIME_STAGE(timings_, preprocess_ms);
+        scale = selectWorkingImage(input_image, roi, region, working);
+        if (scale == 0.0) {
+            return false;
+        }
+        
+        // All intermediate images and contour storage are members, so frames of
+        // a fixed size reuse the same allocations from call to call
+        if (!preprocessImage(working, closed_)) {
+            return false;
+        }
     }
 
-    cv::Mat preprocessed;
-    if (!preprocessImage(input_image, preprocessed)) {
-        return false;
+    // Contours are mapped back into full-image coordinates
+    {
+        ID_READER_TIME_STAGE(timings_, contours_ms);
+        if (!findContours(closed_, scale, region.tl(), contours_, candidates_)) {
+            return false;
+        }
     }
 
-    std::vector<std::vector<cv::Point>> contours;
-    if (!findContours(preprocessed, contours)) {
-        return false;
+    {
+        ID_READER_TIME_STAGE(timings_, quad_selection_ms);
+        if (!findBestDocumentContour(contours_, candidates_, best_candidate_, best_contour_)) {
+            return false;
+        }
     }
 
-    std::vector<cv::Point> best_contour;
-    if (!findBestDocumentContour(contours, best_contour)) {
-        return false;
+    {
+        ID_READER_TIME_STAGE(timings_, bounds_ms);
+        if (!extractDocumentBounds(best_contour_, input_image.size(), bounds)) {
+            return false;
+        }
+        
+        // Recover the precision lost to downscaling, touching only small windows
+        // of the full-resolution image around each coarse corner
+        if (scale < 1.0 && best_contour_.size() == 4) {
+            refineCorners(input_image, scale, bounds);
+        }
     }
-
-    return extractDocumentBounds(best_contour, input_image.size(), bounds);
+    
+    // Calculate confidence based on contour properties
+    {
+        ID_READER_TIME_STAGE(timings_, confidence_ms);
+        bounds.confidence = calculateConfidence(best_candidate_, best_contour_, input_image.size());
+    }
+    
+    return true;
 }
 
 bool DocumentDetector::preprocessImage(const cv::Mat& input, cv::Mat& output) {
-    cv::Mat gray, blurred, edges;
+    detectEdges(input, edges_);
     
-    // Convert to grayscale
-    if (input.channels() == 3) {
-        cv::cvtColor(input, gray, cv::COLOR_BGR2GRAY);
-    } else if (input.channels() == 4) {
-        cv::cvtColor(input, gray, cv::COLOR_BGRA2GRAY);
+    // Morphological operations to close gaps in edges
+    int stripes = stripeCount(edges_.rows);
+    if (stripes > 0) {
+        closeEdgeStripes(edges_, stripes, output);
     } else {
-        gray = input.clone();
+        cv::morphologyEx(edges_, output, cv::MORPH_CLOSE, morph_kernel_);
     }
     
-    // Apply Gaussian blur to reduce noise
-    cv::GaussianBlur(gray, blurred, cv::Size(5, 5), 0);
-    
-    // Edge detection using Canny
-    cv::Canny(blurred, edges, canny_threshold1_, canny_threshold2_);
-    
-    // Morphological operations to close gaps in edges
-    cv::Mat kernel = cv::getStructuringElement(cv::MORPH_RECT, cv::Size(3, 3));
-    cv::morphologyEx(edges, output, cv::MORPH_CLOSE, kernel);
-    
     return true;
 }
 
-bool DocumentDetector::findContours(const cv::Mat& edge_image, std::vector<std::vector<cv::Point>>& contours) {
-    std::vector<cv::Vec4i> hierarchy;
-    cv::findContours(edge_image, contours, hierarchy, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+void DocumentDetector::closeEdgeStripes(const cv::Mat& edges, int stripes, cv::Mat& output) {
+    if (stripe_closed_.size() < pool_->size() + 1) {
+        stripe_closed_.resize(pool_->size() + 1);
+    }
+    
+    // Closing is a dilation followed by an erosion, so each output row depends
+    // on the edge rows within twice the kernel's half-height. Every stripe is
+    // closed together with that halo, isolated from the rows beyond it; only
+    // the halo rows themselves see the artificial border.
+    const int rows = edges.rows;
+    const int halo = 2 * (morph_kernel_.rows / 2);
+    output.create(edges.size(), CV_8UC1);
+    pool_->parallelFor(stripes, [&](size_t index, size_t worker) {
+        int stripe = static_cast<int>(index);
+        int begin = stripeBegin(rows, stripes, stripe);
+        int end = stripeBegin(rows, stripes, stripe + 1);
+        int halo_begin = std::max(begin - halo, 0);
+        int halo_end = std::min(end + halo, rows);
+        
+        cv::Mat& closed = stripe_closed_[worker];
+        cv::morphologyEx(edges.rowRange(halo_begin, halo_end), closed, cv::MORPH_CLOSE, morph_kernel_,
+                         cv::Point(-1, -1), 1, cv::BORDER_CONSTANT | cv::BORDER_ISOLATED);
+        
+        cv::Mat destination = output.rowRange(begin, end);
+        closed.rowRange(begin - halo_begin, end - halo_begin).copyTo(destination);
+    });
+}
+
+bool DocumentDetector::findContours(const cv::Mat& edge_image, double scale, const cv::Point& offset,
+                                    std::vector<std::vector<cv::Point>>& contours,
+                                    std::vector<ContourCandidate>& candidates) {
+    if (scale == 1.0) {
+        cv::findContours(edge_image, contours, hierarchy_, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE, offset);
+    } else {
+        cv::findContours(edge_image, contours, hierarchy_, cv::RETR_EXTERNAL, cv::CHAIN_APPROX_SIMPLE);
+        
+        // Contours from a pyramid level are scaled up so area limits and
+        // confidence stay in full-resolution units
+        double inv_scale = 1.0 / scale;
+        for (auto& contour : contours) {
+            for (auto& point : contour) {
+                point.x = cvRound(point.x * inv_scale) + offset.x;
+                point.y = cvRound(point.y * inv_scale) + offset.y;
+            }
+        }
+    }
     
     if (contours.empty()) {
         return false;
     }
     
-    // Filter contours by area
-    contours.erase(
-        std::remove_if(contours.begin(), contours.end(),
-            [this](const std::vector<cv::Point>& contour) {
-                double area = cv::contourArea(contour);
-                return area < min_contour_area_ || area > max_contour_area_;
-            }),
-        contours.end()
-    );
+    // Filter contours by area. Surviving indices are recorded with their
+    // area instead of erasing the rest, so the contour vectors keep their
+    // capacity and no later stage recomputes the area.
+    candidates.clear();
+    for (size_t i = 0; i < contours.size(); ++i) {
+        double area = cv::contourArea(contours[i]);
+        if (area >= settings_.min_contour_area && area <= settings_.max_contour_area) {
+            ContourCandidate candidate;
+            candidate.index = static_cast<int>(i);
+            candidate.area = area;
+            candidates.push_back(candidate);
+        }
+    }
     
-    return !contours.empty();
+    return !candidates.empty();
 }
 
 bool DocumentDetector::findBestDocumentContour(const std::vector<std::vector<cv::Point>>& contours, 
+                                               std::vector<ContourCandidate>& candidates,
+                                               ContourCandidate& best_candidate,
                                                std::vector<cv::Point>& best_contour) {
-    double max_area = 0;
-    int best_contour_index = -1;
+    if (candidates.empty()) {
+        return false;
+    }
     
-    for (size_t i = 0; i < contours.size(); ++i) {
+    // Candidates are examined largest first, so the first one that
+    // approximates to a quadrilateral is the best quad and nothing smaller
+    // needs its polygon approximated. A heap makes each step O(log n)
+    // without sorting the clutter that is never reached.
+    auto smaller = [](const ContourCandidate& a, const ContourCandidate& b) { return a.area < b.area; };
+    std::make_heap(candidates.begin(), candidates.end(), smaller);
+    
+    for (auto remaining = candidates.end(); remaining != candidates.begin(); --remaining) {
+        std::pop_heap(candidates.begin(), remaining, smaller);
+        ContourCandidate& candidate = *(remaining - 1);
+        const std::vector<cv::Point>& contour = contours[candidate.index];
+        
         // Approximate contour to reduce number of points
-        std::vector<cv::Point> approx;
-        double epsilon = approx_epsilon_factor_ * cv::arcLength(contours[i], true);
-        cv::approxPolyDP(contours[i], approx, epsilon, true);
+        candidate.perimeter = cv::arcLength(contour, true);
+        double epsilon = settings_.approx_epsilon_factor * candidate.perimeter;
+        cv::approxPolyDP(contour, approx_, epsilon, true);
+        candidate.vertices = static_cast<int>(approx_.size());
         
-        // Look for quadrilaterals (4 corners)
-        if (approx.size() == 4) {
-            double area = cv::contourArea(approx);
-            if (area > max_area) {
-                max_area = area;
-                best_contour_index = i;
-                best_contour = approx;
-            }
-        }
-    }
-    
-    // If no quadrilateral found, use the largest contour
-    if (best_contour_index == -1 && !contours.empty()) {
-        for (size_t i = 0; i < contours.size(); ++i) {
-            double area = cv::contourArea(contours[i]);
-            if (area > max_area) {
-                max_area = area;
-                best_contour_index = i;
-            }
+        // Look for quadrilaterals (4 corners). The largest contour is kept
+        // as the fallback in case no quadrilateral turns up.
+        bool is_quad = candidate.vertices == 4;
+        if (is_quad || remaining == candidates.end()) {
+            best_candidate = candidate;
+            best_contour.assign(approx_.begin(), approx_.end());
         }
-        
-        if (best_contour_index != -1) {
-            // Approximate the largest contour
-            double epsilon = approx_epsilon_factor_ * cv::arcLength(contours[best_contour_index], true);
-            cv::approxPolyDP(contours[best_contour_index], best_contour, epsilon, true);
+        if (is_quad) {
+            return true;
         }
     }
     
-    return best_contour_index != -1;
+    return true;
 }
 
 bool DocumentDetector::extractDocumentBounds(const std::vector<cv::Point>& contour, 
@@ -149,7 +217,8 @@ bool DocumentDetector::extractDocumentBounds(const std::vector<cv::Point>& conto
     // If we have exactly 4 points, use them directly
     if (contour.size() == 4) {
         // Sort points to get consistent ordering (top-left, top-right, bottom-right, bottom-left)
-        std::vector<cv::Point> sorted_points = sortCornerPoints(contour);
+        std::vector<cv::Point>& sorted_points = sorted_corners_;
+        sortCornerPoints(contour, sorted_points);
         
         bounds.x1 = static_cast<float>(sorted_points[0].x) / image_size.width;
         bounds.y1 = static_cast<float>(sorted_points[0].y) / image_size.height;
@@ -173,18 +242,16 @@ bool DocumentDetector::extractDocumentBounds(const std::vector<cv::Point>& conto
         bounds.y4 = static_cast<float>(bounding_rect.y + bounding_rect.height) / image_size.height;
     }
     
-    // Calculate confidence based on contour properties
-    bounds.confidence = calculateConfidence(contour, image_size);
-    
     return true;
 }
 
-std::vector<cv::Point> DocumentDetector::sortCornerPoints(const std::vector<cv::Point>& points) {
+void DocumentDetector::sortCornerPoints(const std::vector<cv::Point>& points, std::vector<cv::Point>& sorted_points) {
     if (points.size() != 4) {
-        return points;
+        sorted_points = points;
+        return;
     }
     
-    std::vector<cv::Point> sorted_points(4);
+    sorted_points.resize(4);
     
     // Calculate centroid
     cv::Point centroid(0, 0);
@@ -196,15 +263,16 @@ std::vector<cv::Point> DocumentDetector::sortCornerPoints(const std::vector<cv::
     centroid.y /= 4;
     
     // Sort points by their position relative to centroid
-    std::vector<std::pair<cv::Point, int>> point_quadrants;
-    for (const auto& point : points) {
+    std::array<std::pair<cv::Point, int>, 4> point_quadrants;
+    for (size_t i = 0; i < points.size(); ++i) {
+        const cv::Point& point = points[i];
         int quadrant = 0;
         if (point.x >= centroid.x && point.y < centroid.y) quadrant = 0; // top-right
         else if (point.x < centroid.x && point.y < centroid.y) quadrant = 1; // top-left
         else if (point.x < centroid.x && point.y >= centroid.y) quadrant = 2; // bottom-left
         else quadrant = 3; // bottom-right
         
-        point_quadrants.push_back({point, quadrant});
+        point_quadrants[i] = {point, quadrant};
     }
     
     std::sort(point_quadrants.begin(), point_quadrants.end(),
@@ -217,54 +285,48 @@ std::vector<cv::Point> DocumentDetector::sortCornerPoints(const std::vector<cv::
     sorted_points[1] = point_quadrants[0].first; // top-right
     sorted_points[2] = point_quadrants[3].first; // bottom-right
     sorted_points[3] = point_quadrants[2].first; // bottom-left
-    
-    return sorted_points;
 }
 
-float DocumentDetector::calculateConfidence(const std::vector<cv::Point>& contour, const cv::Size& image_size) {
-    if (contour.empty()) {
+float DocumentDetector::calculateConfidence(const ContourCandidate& candidate,
+                                            const std::vector<cv::Point>& polygon,
+                                            const cv::Size& image_size) {
+    if (polygon.empty()) {
         return 0.0f;
     }
     
-    double contour_area = cv::contourArea(contour);
-    double image_area = image_size.width * image_size.height;
-    double area_ratio = contour_area / image_area;
-    
-    // Confidence based on area ratio (documents should occupy reasonable portion of image)
-    float area_confidence = 0.0f;
-    if (area_ratio >= 0.1 && area_ratio <= 0.8) {
-        area_confidence = 1.0f - std::abs(0.4f - static_cast<float>(area_ratio)) / 0.4f;
-    }
+    // Confidence based on area ratio. Area and perimeter were cached by
+    // contour filtering and quad selection.
+    float area_confidence = areaConfidence(candidate.area, image_size);
     
     // Confidence based on contour approximation quality
-    double perimeter = cv::arcLength(contour, true);
-    std::vector<cv::Point> approx;
-    cv::approxPolyDP(contour, approx, 0.02 * perimeter, true);
-    
     float shape_confidence = 0.0f;
-    if (approx.size() == 4) {
+    if (candidate.vertices == 4) {
         shape_confidence = 1.0f;
-    } else if (approx.size() >= 3 && approx.size() <= 6) {
+    } else if (candidate.vertices >= 3 && candidate.vertices <= 6) {
         shape_confidence = 0.7f;
     } else {
         shape_confidence = 0.3f;
     }
     
-    return (area_confidence + shape_confidence) / 2.0f;
-}
-
-void DocumentDetector::setCannyThresholds(double threshold1, double threshold2) {
-    canny_threshold1_ = threshold1;
-    canny_threshold2_ = threshold2;
-}
-
-void DocumentDetector::setContourAreaRange(double min_area, double max_area) {
-    min_contour_area_ = min_area;
-    max_contour_area_ = max_area;
-}
-
-void DocumentDetector::setApproximationEpsilon(double epsilon_factor) {
-    approx_epsilon_factor_ = epsilon_factor;
+    // Confidence based on agreement with standard document proportions.
+    // Quads use the mean lengths of opposite sides, which tolerates some
+    // perspective; other shapes fall back to their minimum-area rectangle.
+    double long_side = 0.0;
+    double short_side = 0.0;
+    if (polygon.size() == 4) {
+        double side_a = (cv::norm(polygon[1] - polygon[0]) + cv::norm(polygon[3] - polygon[2])) / 2.0;
+        double side_b = (cv::norm(polygon[2] - polygon[1]) + cv::norm(polygon[0] - polygon[3])) / 2.0;
+        long_side = std::max(side_a, side_b);
+        short_side = std::min(side_a, side_b);
+    } else {
+        cv::RotatedRect rect = cv::minAreaRect(polygon);
+        long_side = std::max(rect.size.width, rect.size.height);
+        short_side = std::min(rect.size.width, rect.size.height);
+    }
+    
+    float aspect_confidence = aspectConfidence(long_side, short_side);
+    
+    return (area_confidence + shape_confidence + aspect_confidence) / 3.0f;
 }
 
 } // namespace preprocessing
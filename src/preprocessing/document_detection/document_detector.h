@@ -14,39 +14,43 @@
 #include <opencv2/opencv.hpp>
 #include <vector>
 
+#include "document_detector_base.h"
+
 namespace id_reader {
 namespace preprocessing {
 
-struct DocumentBounds {
-    float x1, y1;  // Top-left corner (normalized coordinates 0-1)
-    float x2, y2;  // Top-right corner
-    float x3, y3;  // Bottom-right corner
-    float x4, y4;  // Bottom-left corner
-    float confidence;  // Detection confidence (0-1)
-    
-    DocumentBounds() : x1(0), y1(0), x2(0), y2(0), x3(0), y3(0), x4(0), y4(0), confidence(0) {}
+// Contour that passed the area filter. Geometry is computed at most once per
+// call and shared by quad selection and confidence scoring; perimeter and
+// vertices stay 0 until quad selection has examined the contour.
+struct ContourCandidate {
+    int index = -1;
+    double area = 0.0;
+    double perimeter = 0.0;
+    int vertices = 0;  // Corners of the polygon approximation
 };
 
-class DocumentDetector {
+// Contour engine: Canny edges closed by morphology, external contours, and
+// the largest one that approximates to a quadrilateral
+class DocumentDetector : public DocumentDetectorBase {
 public:
     DocumentDetector();
-    ~DocumentDetector();
-    
-    // Main detection function
-    bool detectDocument(const cv::Mat& input_image, DocumentBounds& bounds);
+    explicit DocumentDetector(const DetectorSettings& settings);
+    ~DocumentDetector() override;
     
-    // Configuration methods
-    void setCannyThresholds(double threshold1, double threshold2);
-    void setContourAreaRange(double min_area, double max_area);
-    void setApproximationEpsilon(double epsilon_factor);
+    bool detectDocumentInRegion(const cv::Mat& input_image, const cv::Rect& roi, DocumentBounds& bounds) override;
     
 private:
     // Image preprocessing
     bool preprocessImage(const cv::Mat& input, cv::Mat& output);
+    void closeEdgeStripes(const cv::Mat& edges, int stripes, cv::Mat& output);
     
     // Contour detection and filtering
-    bool findContours(const cv::Mat& edge_image, std::vector<std::vector<cv::Point>>& contours);
+    bool findContours(const cv::Mat& edge_image, double scale, const cv::Point& offset,
+                      std::vector<std::vector<cv::Point>>& contours,
+                      std::vector<ContourCandidate>& candidates);
     bool findBestDocumentContour(const std::vector<std::vector<cv::Point>>& contours, 
+                                 std::vector<ContourCandidate>& candidates,
+                                 ContourCandidate& best_candidate,
                                  std::vector<cv::Point>& best_contour);
     
     // Document bounds extraction
@@ -55,18 +59,25 @@ private:
                               DocumentBounds& bounds);
     
     // Helper methods
-    std::vector<cv::Point> sortCornerPoints(const std::vector<cv::Point>& points);
-    float calculateConfidence(const std::vector<cv::Point>& contour, const cv::Size& image_size);
+    void sortCornerPoints(const std::vector<cv::Point>& points, std::vector<cv::Point>& sorted_points);
+    float calculateConfidence(const ContourCandidate& candidate, const std::vector<cv::Point>& polygon,
+                              const cv::Size& image_size);
     
-    // Detection parameters
-    double canny_threshold1_;
-    double canny_threshold2_;
-    double min_contour_area_;
-    double max_contour_area_;
-    double approx_epsilon_factor_;
+    // Contour engine scratch, reused across calls like the shared buffers
+    cv::Mat morph_kernel_;
+    cv::Mat edges_;
+    std::vector<cv::Mat> stripe_closed_;  // One per pool worker
+    cv::Mat closed_;
+    std::vector<std::vector<cv::Point>> contours_;
+    std::vector<cv::Vec4i> hierarchy_;
+    std::vector<ContourCandidate> candidates_;
+    std::vector<cv::Point> approx_;
+    ContourCandidate best_candidate_;
+    std::vector<cv::Point> best_contour_;  // Polygon approximation of best_candidate_
+    std::vector<cv::Point> sorted_corners_;
 };
 
 } // namespace preprocessing
 } // namespace id_reader
 
-#endif // ID_READER_DOCUMENT_DETECTOR_H
\ No newline at end of file
+#endif // ID_READER_DOCUMENT_DETECTOR_H
@@ -0,0 +1,230 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "document_detector_base.h"
+#include "document_detector.h"
+#include "line_document_detector.h"
+#include <opencv2/opencv.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+namespace id_reader {
+namespace preprocessing {
+
+namespace {
+
+// Shortest stripe worth handing to a worker in parallel preprocessing
+constexpr int kMinStripeRows = 64;
+
+// Long/short side ratios of ID-1 cards (85.60 x 53.98 mm, also ICAO TD1) and
+// TD3 passport pages (125 x 88 mm, within 0.2% of TD2). Aspect confidence
+// falls to zero at a 25% mismatch with the nearer of the two.
+constexpr double kAspectId1 = 85.60 / 53.98;
+constexpr double kAspectTd3 = 125.0 / 88.0;
+const double kAspectTolerance = std::log(1.25);
+
+} // namespace
+
+DocumentDetectorBase::DocumentDetectorBase(const DetectorSettings& settings) : settings_(settings) {}
+
+DocumentDetectorBase::~DocumentDetectorBase() = default;
+
+bool DocumentDetectorBase::detectDocument(const cv::Mat& input_image, DocumentBounds& bounds) {
+    return detectDocumentInRegion(input_image, cv::Rect(0, 0, input_image.cols, input_image.rows), bounds);
+}
+
+double DocumentDetectorBase::selectWorkingImage(const cv::Mat& input_image, const cv::Rect& roi,
+                                                cv::Rect& region, cv::Mat& working) {
+    region = roi & cv::Rect(0, 0, input_image.cols, input_image.rows);
+    if (input_image.empty() || region.empty()) {
+        return 0.0;
+    }
+    
+    // In pyramid mode the edge search runs on a downscaled copy so its cost
+    // no longer grows with sensor resolution. Area averaging uses every
+    // source pixel, so fine texture cannot alias into false edges; a blur
+    // after point sampling could not undo that.
+    working = input_image(region);
+    double scale = 1.0;
+    int longest_side = std::max(region.width, region.height);
+    if (settings_.pyramid_enabled && longest_side > settings_.pyramid_max_dimension) {
+        scale = static_cast<double>(settings_.pyramid_max_dimension) / longest_side;
+        cv::resize(working, downscaled_, cv::Size(), scale, scale, cv::INTER_AREA);
+        working = downscaled_;
+    }
+    return scale;
+}
+
+void DocumentDetectorBase::detectEdges(const cv::Mat& input, cv::Mat& edges) {
+    // Convert to grayscale. Single-channel input is already luma and is
+    // blurred in place rather than copied into gray_.
+    const cv::Mat* gray = &input;
+    if (input.channels() == 3) {
+        cv::cvtColor(input, gray_, cv::COLOR_BGR2GRAY);
+        gray = &gray_;
+    } else if (input.channels() == 4) {
+        cv::cvtColor(input, gray_, cv::COLOR_BGRA2GRAY);
+        gray = &gray_;
+    }
+    
+    const int stripes = stripeCount(gray->rows);
+    if (stripes > 0) {
+        // Each stripe's gradients read the luma rows around it directly, so
+        // the stripes can be computed independently
+        const int rows = gray->rows;
+        if (stripe_scratch_.size() < pool_->size() + 1) {
+            stripe_scratch_.resize(pool_->size() + 1);
+        }
+        grad_x_.create(gray->size(), CV_16SC1);
+        grad_y_.create(gray->size(), CV_16SC1);
+        pool_->parallelFor(stripes, [&](size_t index, size_t worker) {
+            int stripe = static_cast<int>(index);
+            fusedBlurSobelRows(*gray, stripeBegin(rows, stripes, stripe), stripeBegin(rows, stripes, stripe + 1),
+                               grad_x_, grad_y_, stripe_scratch_[worker]);
+        });
+        
+        // Hysteresis can follow an edge across any number of stripes, so Canny
+        // runs over the whole gradient image (OpenCV parallelizes it internally)
+        cv::Canny(grad_x_, grad_y_, edges, settings_.canny_threshold1, settings_.canny_threshold2);
+    } else if (settings_.fused_preprocessing) {
+        // Blur and gradients in a single pass over the luma rows; Canny
+        // then only does non-maximum suppression and hysteresis
+        fusedBlurSobel(*gray, grad_x_, grad_y_, fused_scratch_);
+        cv::Canny(grad_x_, grad_y_, edges, settings_.canny_threshold1, settings_.canny_threshold2);
+    } else {
+        // Apply Gaussian blur to reduce noise
+        cv::GaussianBlur(*gray, blurred_, cv::Size(5, 5), 0);
+        
+        // Edge detection using Canny
+        cv::Canny(blurred_, edges, settings_.canny_threshold1, settings_.canny_threshold2);
+    }
+}
+
+int DocumentDetectorBase::stripeCount(int rows) const {
+    if (!settings_.parallel_preprocessing || !pool_ || rows < 2 * kMinStripeRows) {
+        return 0;
+    }
+    
+    // A few stripes per thread so uneven stripes balance out across workers
+    return static_cast<int>(std::min<size_t>(rows / kMinStripeRows, (pool_->size() + 1) * 4));
+}
+
+int DocumentDetectorBase::stripeBegin(int rows, int stripes, int stripe) {
+    return static_cast<int>(static_cast<int64_t>(rows) * stripe / stripes);
+}
+
+void DocumentDetectorBase::refineCorners(const cv::Mat& image, double scale, DocumentBounds& bounds) {
+    float* xs[4] = {&bounds.x1, &bounds.x2, &bounds.x3, &bounds.x4};
+    float* ys[4] = {&bounds.y1, &bounds.y2, &bounds.y3, &bounds.y4};
+    const cv::Rect image_rect(0, 0, image.cols, image.rows);
+    
+    // A coarse corner can be off by about two pixels of the downscaled image
+    const int search_radius = std::min(24, std::max(3, static_cast<int>(std::ceil(2.0 / scale))));
+    
+    // cornerSubPix needs its search window plus a gradient margin
+    const int patch_size = 2 * search_radius + 5;
+    
+    for (int i = 0; i < 4; ++i) {
+        cv::Point2f corner(*xs[i] * image.cols, *ys[i] * image.rows);
+        cv::Rect patch_rect(cvFloor(corner.x) - patch_size / 2, cvFloor(corner.y) - patch_size / 2,
+                            patch_size, patch_size);
+        if ((patch_rect & image_rect).area() != patch_rect.area()) {
+            continue; // Too close to the image border to refine
+        }
+        
+        cv::Mat patch = image(patch_rect);
+        if (image.channels() == 3) {
+            cv::cvtColor(patch, refine_patch_, cv::COLOR_BGR2GRAY);
+            patch = refine_patch_;
+        } else if (image.channels() == 4) {
+            cv::cvtColor(patch, refine_patch_, cv::COLOR_BGRA2GRAY);
+            patch = refine_patch_;
+        }
+        
+        cv::Point2f patch_origin(static_cast<float>(patch_rect.x), static_cast<float>(patch_rect.y));
+        std::vector<cv::Point2f>& points = refine_points_;
+        points.assign(1, corner - patch_origin);
+        cv::cornerSubPix(patch, points, cv::Size(search_radius, search_radius), cv::Size(-1, -1),
+                         cv::TermCriteria(cv::TermCriteria::COUNT + cv::TermCriteria::EPS, 20, 0.05));
+        
+        // Keep the coarse corner if refinement wandered out of its window
+        cv::Point2f refined = points[0] + patch_origin;
+        if (std::abs(refined.x - corner.x) <= search_radius &&
+            std::abs(refined.y - corner.y) <= search_radius) {
+            *xs[i] = refined.x / image.cols;
+            *ys[i] = refined.y / image.rows;
+        }
+    }
+}
+
+float DocumentDetectorBase::areaConfidence(double area, const cv::Size& image_size) {
+    double image_area = image_size.width * image_size.height;
+    double area_ratio = area / image_area;
+    
+    // Documents should occupy a reasonable portion of the image
+    if (area_ratio >= 0.1 && area_ratio <= 0.8) {
+        return 1.0f - std::abs(0.4f - static_cast<float>(area_ratio)) / 0.4f;
+    }
+    return 0.0f;
+}
+
+float DocumentDetectorBase::aspectConfidence(double long_side, double short_side) {
+    if (short_side <= 0.0) {
+        return 0.0f;
+    }
+    
+    double aspect = long_side / short_side;
+    double deviation = std::min(std::abs(std::log(aspect / kAspectId1)),
+                                std::abs(std::log(aspect / kAspectTd3)));
+    return static_cast<float>(std::max(0.0, 1.0 - deviation / kAspectTolerance));
+}
+
+void DocumentDetectorBase::setCannyThresholds(double threshold1, double threshold2) {
+    settings_.canny_threshold1 = threshold1;
+    settings_.canny_threshold2 = threshold2;
+}
+
+void DocumentDetectorBase::setContourAreaRange(double min_area, double max_area) {
+    settings_.min_contour_area = min_area;
+    settings_.max_contour_area = max_area;
+}
+
+void DocumentDetectorBase::setApproximationEpsilon(double epsilon_factor) {
+    settings_.approx_epsilon_factor = epsilon_factor;
+}
+
+void DocumentDetectorBase::setPyramidDetection(bool enabled, int max_dimension) {
+    settings_.pyramid_enabled = enabled;
+    settings_.pyramid_max_dimension = std::max(64, max_dimension);
+}
+
+void DocumentDetectorBase::setFusedPreprocessing(bool enabled) {
+    settings_.fused_preprocessing = enabled;
+}
+
+void DocumentDetectorBase::setParallelPreprocessing(bool enabled, core::ThreadPool* pool) {
+    settings_.parallel_preprocessing = enabled;
+    pool_ = pool;
+}
+
+std::unique_ptr<DocumentDetectorBase> createDocumentDetector(const DetectorSettings& settings) {
+    switch (settings.engine) {
+        case DetectorEngine::Lines:
+            return std::make_unique<LineDocumentDetector>(settings);
+        case DetectorEngine::Contour:
+        default:
+            return std::make_unique<DocumentDetector>(settings);
+    }
+}
+
+} // namespace preprocessing
+} // namespace id_reader
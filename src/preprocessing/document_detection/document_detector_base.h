@@ -0,0 +1,155 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_DOCUMENT_DETECTOR_BASE_H
+#define ID_READER_DOCUMENT_DETECTOR_BASE_H
+
+#include <opencv2/opencv.hpp>
+#include <memory>
+#include <vector>
+
+#include "../../core/stage_timer.h"
+#include "../../core/thread_pool.h"
+#include "../image_filters/fused_gradient.h"
+
+namespace id_reader {
+namespace preprocessing {
+
+struct DocumentBounds {
+    float x1, y1;  // Top-left corner (normalized coordinates 0-1)
+    float x2, y2;  // Top-right corner
+    float x3, y3;  // Bottom-right corner
+    float x4, y4;  // Bottom-left corner
+    float confidence;  // Detection confidence (0-1)
+    
+    DocumentBounds() : x1(0), y1(0), x2(0), y2(0), x3(0), y3(0), x4(0), y4(0), confidence(0) {}
+};
+
+// Available detection strategies
+enum class DetectorEngine {
+    Contour,  // Closed external contours approximated to quadrilaterals
+    Lines     // Straight edge segments intersected into quadrilaterals
+};
+
+struct DetectorSettings {
+    DetectorEngine engine = DetectorEngine::Contour;
+    double canny_threshold1 = 50;
+    double canny_threshold2 = 150;
+    double min_contour_area = 10000;
+    double max_contour_area = 500000;
+    double approx_epsilon_factor = 0.02;
+    bool pyramid_enabled = false;
+    int pyramid_max_dimension = 640;
+    bool fused_preprocessing = false;
+    bool parallel_preprocessing = false;
+    
+    // Line engine
+    int line_vote_threshold = 40;          // Hough accumulator votes per segment
+    double line_min_length_factor = 0.1;   // Shortest segment, as a fraction of the shorter image side
+    double line_min_coverage = 0.5;        // Fraction of the quad perimeter backed by edge segments
+};
+
+// Interface shared by the detection engines, together with the machinery
+// they have in common: region and pyramid handling, edge detection, corner
+// refinement and the configuration setters.
+class DocumentDetectorBase {
+public:
+    explicit DocumentDetectorBase(const DetectorSettings& settings);
+    virtual ~DocumentDetectorBase();
+    
+    // Detectors own their scratch buffers and are never shared or copied
+    DocumentDetectorBase(const DocumentDetectorBase&) = delete;
+    DocumentDetectorBase& operator=(const DocumentDetectorBase&) = delete;
+    
+    // Main detection function
+    bool detectDocument(const cv::Mat& input_image, DocumentBounds& bounds);
+    
+    // Detection restricted to a region of interest. Only pixels inside `roi`
+    // are processed, but bounds and confidence are relative to the full image.
+    virtual bool detectDocumentInRegion(const cv::Mat& input_image, const cv::Rect& roi,
+                                        DocumentBounds& bounds) = 0;
+    
+    // Configuration methods
+    void setCannyThresholds(double threshold1, double threshold2);
+    void setContourAreaRange(double min_area, double max_area);
+    void setApproximationEpsilon(double epsilon_factor);
+    
+    // Coarse-to-fine mode: the quad is found on a copy downscaled so its
+    // longest side is at most max_dimension, then each corner is refined to
+    // sub-pixel accuracy in a small full-resolution window
+    void setPyramidDetection(bool enabled, int max_dimension = 640);
+    
+    // Compute the blur and Sobel gradients feeding Canny in one streaming
+    // pass instead of writing and re-reading a full blurred image. On full
+    // frames the edges are identical to the separate-pass path.
+    void setFusedPreprocessing(bool enabled);
+    
+    // Split preprocessing of large images into horizontal stripes run on
+    // `pool`. Gradients and morphology are computed per stripe (with the halo
+    // rows each needs); Canny's hysteresis still sees the whole gradient
+    // image, so the edge map is identical to the serial fused path. The pool
+    // is not owned and must outlive the detector; nullptr disables the mode.
+    void setParallelPreprocessing(bool enabled, core::ThreadPool* pool);
+    
+    const DetectorSettings& settings() const { return settings_; }
+    
+    // Stage timings are accumulated into the given record while it is set;
+    // nullptr (the default) disables collection
+    void setStageTimings(core::StageTimings* timings) { timings_ = timings; }
+    
+protected:
+    // Clip `roi` to the image and select the image edge detection runs on:
+    // a view of the region or, in pyramid mode, a downscaled copy of it.
+    // Returns the scale of `working` relative to the input, or 0 when the
+    // region is empty.
+    double selectWorkingImage(const cv::Mat& input_image, const cv::Rect& roi,
+                              cv::Rect& region, cv::Mat& working);
+    
+    // Canny edge map of `input` through the configured blur/gradient path
+    void detectEdges(const cv::Mat& input, cv::Mat& edges);
+    
+    // Stripes for parallel preprocessing of an image with `rows` rows, or 0
+    // when it should be processed serially
+    int stripeCount(int rows) const;
+    static int stripeBegin(int rows, int stripes, int stripe);
+    
+    // Sub-pixel corner refinement at full resolution after detecting at `scale`
+    void refineCorners(const cv::Mat& image, double scale, DocumentBounds& bounds);
+    
+    // Confidence terms shared by the engines, each in [0, 1]
+    static float areaConfidence(double area, const cv::Size& image_size);
+    static float aspectConfidence(double long_side, double short_side);
+    
+    // Detection parameters
+    DetectorSettings settings_;
+    core::StageTimings* timings_ = nullptr;
+    core::ThreadPool* pool_ = nullptr;
+    
+    // Scratch arena reused across calls. cv::Mat::create and std::vector
+    // keep their storage when the frame size is unchanged, so steady-state
+    // calls make no allocations of their own.
+    cv::Mat downscaled_;
+    cv::Mat gray_;
+    cv::Mat blurred_;
+    cv::Mat grad_x_;
+    cv::Mat grad_y_;
+    FusedGradientScratch fused_scratch_;
+    std::vector<FusedGradientScratch> stripe_scratch_;  // One per pool worker
+    cv::Mat refine_patch_;
+    std::vector<cv::Point2f> refine_points_;
+};
+
+// Construct the engine selected by settings.engine
+std::unique_ptr<DocumentDetectorBase> createDocumentDetector(const DetectorSettings& settings);
+
+} // namespace preprocessing
+} // namespace id_reader
+
+#endif // ID_READER_DOCUMENT_DETECTOR_BASE_H
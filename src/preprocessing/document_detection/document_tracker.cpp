@@ -0,0 +1,152 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "document_tracker.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace id_reader {
+namespace preprocessing {
+
+namespace {
+
+float quadArea(const DocumentBounds& b) {
+    // Shoelace formula over the four normalized corners
+    float area = (b.x1 * b.y2 - b.x2 * b.y1) + (b.x2 * b.y3 - b.x3 * b.y2) +
+                 (b.x3 * b.y4 - b.x4 * b.y3) + (b.x4 * b.y1 - b.x1 * b.y4);
+    return std::abs(area) / 2.0f;
+}
+
+float maxCornerShift(const DocumentBounds& a, const DocumentBounds& b) {
+    return std::max({std::abs(a.x1 - b.x1), std::abs(a.y1 - b.y1),
+                     std::abs(a.x2 - b.x2), std::abs(a.y2 - b.y2),
+                     std::abs(a.x3 - b.x3), std::abs(a.y3 - b.y3),
+                     std::abs(a.x4 - b.x4), std::abs(a.y4 - b.y4)});
+}
+
+} // namespace
+
+DocumentTracker::DocumentTracker(DocumentDetectorBase& detector)
+    : detector_(detector), tracking_(false) {
+    // Default tracking parameters
+    search_margin_factor_ = 0.15;
+    smoothing_factor_ = 0.6f;
+}
+
+DocumentTracker::~DocumentTracker() = default;
+
+bool DocumentTracker::trackDocument(const cv::Mat& frame, DocumentBounds& bounds) {
+    if (frame.empty()) {
+        return false;
+    }
+    
+    // A change of resolution invalidates the previous quad
+    if (frame.size() != last_frame_size_) {
+        reset();
+        last_frame_size_ = frame.size();
+    }
+    
+    if (tracking_) {
+        DocumentBounds candidate;
+        if (detector_.detectDocumentInRegion(frame, searchRegion(frame.size()), candidate) &&
+            isConsistentWithTrack(candidate)) {
+            smoothBounds(candidate);
+            last_bounds_ = candidate;
+            bounds = candidate;
+            return true;
+        }
+        
+        // Track lost: fall back to full-frame detection below
+        tracking_ = false;
+    }
+    
+    if (!detector_.detectDocument(frame, bounds)) {
+        return false;
+    }
+    
+    last_bounds_ = bounds;
+    tracking_ = true;
+    return true;
+}
+
+void DocumentTracker::reset() {
+    tracking_ = false;
+    last_bounds_ = DocumentBounds();
+}
+
+cv::Rect DocumentTracker::searchRegion(const cv::Size& frame_size) const {
+    float min_x = std::min({last_bounds_.x1, last_bounds_.x2, last_bounds_.x3, last_bounds_.x4});
+    float max_x = std::max({last_bounds_.x1, last_bounds_.x2, last_bounds_.x3, last_bounds_.x4});
+    float min_y = std::min({last_bounds_.y1, last_bounds_.y2, last_bounds_.y3, last_bounds_.y4});
+    float max_y = std::max({last_bounds_.y1, last_bounds_.y2, last_bounds_.y3, last_bounds_.y4});
+    
+    // Grow the previous bounding box so the document can move between frames
+    double margin_x = (max_x - min_x) * search_margin_factor_;
+    double margin_y = (max_y - min_y) * search_margin_factor_;
+    
+    int x0 = static_cast<int>(std::floor((min_x - margin_x) * frame_size.width));
+    int y0 = static_cast<int>(std::floor((min_y - margin_y) * frame_size.height));
+    int x1 = static_cast<int>(std::ceil((max_x + margin_x) * frame_size.width));
+    int y1 = static_cast<int>(std::ceil((max_y + margin_y) * frame_size.height));
+    
+    return cv::Rect(x0, y0, x1 - x0, y1 - y0) & cv::Rect(0, 0, frame_size.width, frame_size.height);
+}
+
+bool DocumentTracker::isConsistentWithTrack(const DocumentBounds& candidate) const {
+    // Reject quads that jumped further than the search margin allows or whose
+    // size changed abruptly; these are usually clutter inside the region
+    float previous_area = quadArea(last_bounds_);
+    if (previous_area <= 0.0f) {
+        return false;
+    }
+    
+    float area_ratio = quadArea(candidate) / previous_area;
+    if (area_ratio < 0.7f || area_ratio > 1.4f) {
+        return false;
+    }
+    
+    // The margin applies to the larger extent, so portrait and rotated
+    // documents get the same gate as landscape ones
+    float max_x = std::max({last_bounds_.x1, last_bounds_.x2, last_bounds_.x3, last_bounds_.x4});
+    float min_x = std::min({last_bounds_.x1, last_bounds_.x2, last_bounds_.x3, last_bounds_.x4});
+    float max_y = std::max({last_bounds_.y1, last_bounds_.y2, last_bounds_.y3, last_bounds_.y4});
+    float min_y = std::min({last_bounds_.y1, last_bounds_.y2, last_bounds_.y3, last_bounds_.y4});
+    float extent = std::max(max_x - min_x, max_y - min_y);
+    float allowed_shift = static_cast<float>(extent * search_margin_factor_);
+    return maxCornerShift(candidate, last_bounds_) <= allowed_shift;
+}
+
+void DocumentTracker::smoothBounds(DocumentBounds& bounds) const {
+    // Exponential smoothing damps corner jitter between consecutive frames
+    const float a = smoothing_factor_;
+    const float b = 1.0f - smoothing_factor_;
+    bounds.x1 = a * bounds.x1 + b * last_bounds_.x1;
+    bounds.y1 = a * bounds.y1 + b * last_bounds_.y1;
+    bounds.x2 = a * bounds.x2 + b * last_bounds_.x2;
+    bounds.y2 = a * bounds.y2 + b * last_bounds_.y2;
+    bounds.x3 = a * bounds.x3 + b * last_bounds_.x3;
+    bounds.y3 = a * bounds.y3 + b * last_bounds_.y3;
+    bounds.x4 = a * bounds.x4 + b * last_bounds_.x4;
+    bounds.y4 = a * bounds.y4 + b * last_bounds_.y4;
+}
+
+void DocumentTracker::setSearchMargin(double margin_factor) {
+    search_margin_factor_ = margin_factor;
+}
+
+void DocumentTracker::setSmoothing(float smoothing_factor) {
+    // Weight of the newest detection; 1.0 disables smoothing. A small floor
+    // keeps the track from freezing in place.
+    smoothing_factor_ = std::min(1.0f, std::max(0.1f, smoothing_factor));
+}
+
+} // namespace preprocessing
+} // namespace id_reader
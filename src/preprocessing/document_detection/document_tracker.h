@@ -0,0 +1,57 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_DOCUMENT_TRACKER_H
+#define ID_READER_DOCUMENT_TRACKER_H
+
+#include "document_detector_base.h"
+#include <opencv2/opencv.hpp>
+
+namespace id_reader {
+namespace preprocessing {
+
+// Frame-to-frame document tracking for video streams. Each frame is first
+// searched only in a region around the previous quad; full-frame detection
+// runs only when there is no track or the tracked quad is lost.
+class DocumentTracker {
+public:
+    explicit DocumentTracker(DocumentDetectorBase& detector);
+    ~DocumentTracker();
+    
+    // Detect the document in the next frame of the stream
+    bool trackDocument(const cv::Mat& frame, DocumentBounds& bounds);
+    
+    // Forget the current track so the next frame runs full detection
+    void reset();
+    bool isTracking() const { return tracking_; }
+    
+    // Configuration methods
+    void setSearchMargin(double margin_factor);
+    void setSmoothing(float smoothing_factor);
+    
+private:
+    cv::Rect searchRegion(const cv::Size& frame_size) const;
+    bool isConsistentWithTrack(const DocumentBounds& candidate) const;
+    void smoothBounds(DocumentBounds& bounds) const;
+    
+    DocumentDetectorBase& detector_;
+    DocumentBounds last_bounds_;
+    cv::Size last_frame_size_;
+    bool tracking_;
+    
+    // Tracking parameters
+    double search_margin_factor_;
+    float smoothing_factor_;
+};
+
+} // namespace preprocessing
+} // namespace id_reader
+
+#endif // ID_READER_DOCUMENT_TRACKER_H
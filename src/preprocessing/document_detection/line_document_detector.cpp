@@ -0,0 +1,373 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "line_document_detector.h"
+#include <opencv2/opencv.hpp>
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace id_reader {
+namespace preprocessing {
+
+namespace {
+
+// Segments within this angle of a line, and close to it, extend that line
+const double kMergeAngle = 2.0 * CV_PI / 180.0;
+
+// Opposite sides may converge this much under perspective
+const double kParallelAngle = 30.0 * CV_PI / 180.0;
+
+// Adjacent sides must meet at least this steeply
+const double kCrossingAngle = 45.0 * CV_PI / 180.0;
+
+// Only the strongest lines take part in the quad search, which is quadratic
+// in the number of parallel pairs
+constexpr size_t kMaxLines = 12;
+
+// Every side needs some edge evidence of its own
+constexpr double kMinSideCoverage = 0.1;
+
+// How far outside the image an extrapolated corner may lie, as a fraction
+// of the image size
+constexpr double kCornerMargin = 0.25;
+
+double angleBetween(double a, double b) {
+    double difference = std::abs(a - b);
+    return std::min(difference, CV_PI - difference);
+}
+
+bool intersectLines(const cv::Point2d& n1, double c1, const cv::Point2d& n2, double c2, cv::Point2d& point) {
+    double determinant = n1.x * n2.y - n1.y * n2.x;
+    if (std::abs(determinant) < 1e-9) {
+        return false;
+    }
+    point.x = (c1 * n2.y - c2 * n1.y) / determinant;
+    point.y = (n1.x * c2 - n2.x * c1) / determinant;
+    return true;
+}
+
+double signedArea(const std::array<cv::Point2d, 4>& corners) {
+    double sum = 0.0;
+    for (size_t i = 0; i < 4; ++i) {
+        const cv::Point2d& a = corners[i];
+        const cv::Point2d& b = corners[(i + 1) % 4];
+        sum += a.x * b.y - b.x * a.y;
+    }
+    return sum / 2.0;
+}
+
+} // namespace
+
+LineDocumentDetector::LineDocumentDetector() : LineDocumentDetector(DetectorSettings()) {}
+
+LineDocumentDetector::LineDocumentDetector(const DetectorSettings& settings) : DocumentDetectorBase(settings) {}
+
+LineDocumentDetector::~LineDocumentDetector() = default;
+
+bool LineDocumentDetector::detectDocumentInRegion(const cv::Mat& input_image, const cv::Rect& roi,
+                                                  DocumentBounds& bounds) {
+    cv::Rect region;
+    cv::Mat working;
+    double scale = 0.0;
+    {
+        ID_READER_TIME_STAGE(timings_, preprocess_ms);
+        scale = selectWorkingImage(input_image, roi, region, working);
+        if (scale == 0.0) {
+            return false;
+        }
+        
+        // No morphological closing: gaps in an edge only shorten a segment
+        detectEdges(working, edges_);
+    }
+    
+    // Segment extraction takes the place of contour tracing in this engine
+    {
+        ID_READER_TIME_STAGE(timings_, contours_ms);
+        if (!extractLines(edges_)) {
+            return false;
+        }
+    }
+    
+    QuadCandidate best;
+    {
+        ID_READER_TIME_STAGE(timings_, quad_selection_ms);
+        if (!findBestQuad(working.size(), scale, best)) {
+            return false;
+        }
+    }
+    
+    std::array<cv::Point2d, 4> corners;
+    {
+        ID_READER_TIME_STAGE(timings_, bounds_ms);
+        
+        // Back to full-image coordinates, then reorder to top-left,
+        // top-right, bottom-right, bottom-left: start from the corner
+        // nearest the origin and run clockwise (positive area with y down)
+        const cv::Point2d offset(region.x, region.y);
+        size_t start = 0;
+        for (size_t i = 0; i < 4; ++i) {
+            corners[i] = best.corners[i] * (1.0 / scale) + offset;
+            if (corners[i].x + corners[i].y < corners[start].x + corners[start].y) {
+                start = i;
+            }
+        }
+        int step = signedArea(corners) > 0 ? 1 : 3;
+        std::array<cv::Point2d, 4> ordered;
+        for (size_t i = 0; i < 4; ++i) {
+            ordered[i] = corners[(start + i * step) % 4];
+        }
+        corners = ordered;
+        
+        bounds.x1 = static_cast<float>(corners[0].x / input_image.cols);
+        bounds.y1 = static_cast<float>(corners[0].y / input_image.rows);
+        bounds.x2 = static_cast<float>(corners[1].x / input_image.cols);
+        bounds.y2 = static_cast<float>(corners[1].y / input_image.rows);
+        bounds.x3 = static_cast<float>(corners[2].x / input_image.cols);
+        bounds.y3 = static_cast<float>(corners[2].y / input_image.rows);
+        bounds.x4 = static_cast<float>(corners[3].x / input_image.cols);
+        bounds.y4 = static_cast<float>(corners[3].y / input_image.rows);
+        
+        // Corners outside the image, or too close to its border, keep their
+        // extrapolated position
+        if (scale < 1.0) {
+            refineCorners(input_image, scale, bounds);
+        }
+    }
+    
+    // Edge coverage plays the part the polygon shape plays for contours
+    {
+        ID_READER_TIME_STAGE(timings_, confidence_ms);
+        double side_a = (cv::norm(corners[1] - corners[0]) + cv::norm(corners[3] - corners[2])) / 2.0;
+        double side_b = (cv::norm(corners[2] - corners[1]) + cv::norm(corners[0] - corners[3])) / 2.0;
+        float area_confidence = areaConfidence(best.area / (scale * scale), input_image.size());
+        float aspect_confidence = aspectConfidence(std::max(side_a, side_b), std::min(side_a, side_b));
+        bounds.confidence = (area_confidence + static_cast<float>(best.coverage) + aspect_confidence) / 3.0f;
+    }
+    
+    return true;
+}
+
+bool LineDocumentDetector::extractLines(const cv::Mat& edges) {
+    const int short_side = std::min(edges.cols, edges.rows);
+    const int long_side = std::max(edges.cols, edges.rows);
+    cv::HoughLinesP(edges, segments_, 1, CV_PI / 180, settings_.line_vote_threshold,
+                    settings_.line_min_length_factor * short_side, 0.01 * long_side);
+    if (segments_.empty()) {
+        return false;
+    }
+    
+    // Longest segments first, so each line is anchored on its strongest evidence
+    auto length = [](const cv::Vec4i& s) { return std::hypot(s[2] - s[0], s[3] - s[1]); };
+    segment_order_.resize(segments_.size());
+    std::iota(segment_order_.begin(), segment_order_.end(), 0);
+    std::sort(segment_order_.begin(), segment_order_.end(),
+              [&](int a, int b) { return length(segments_[a]) > length(segments_[b]); });
+    
+    const double merge_distance = std::max(2.0, 0.01 * short_side);
+    lines_.clear();
+    segment_line_.assign(segments_.size(), -1);
+    for (int index : segment_order_) {
+        const cv::Vec4i& segment = segments_[index];
+        cv::Point2d a(segment[0], segment[1]);
+        cv::Point2d b(segment[2], segment[3]);
+        double segment_length = cv::norm(b - a);
+        if (segment_length <= 0.0) {
+            continue;
+        }
+        
+        cv::Point2d direction = (b - a) * (1.0 / segment_length);
+        double angle = std::atan2(direction.y, direction.x);
+        if (angle < 0.0) {
+            angle += CV_PI;
+        }
+        
+        int match = -1;
+        for (size_t i = 0; i < lines_.size() && match < 0; ++i) {
+            const EdgeLine& line = lines_[i];
+            if (angleBetween(angle, line.angle) < kMergeAngle &&
+                std::abs(line.normal.dot(a) - line.offset) < merge_distance &&
+                std::abs(line.normal.dot(b) - line.offset) < merge_distance) {
+                match = static_cast<int>(i);
+            }
+        }
+        if (match < 0) {
+            EdgeLine line;
+            line.normal = cv::Point2d(-direction.y, direction.x);
+            line.offset = line.normal.dot(a);
+            line.angle = angle;
+            lines_.push_back(line);
+            match = static_cast<int>(lines_.size()) - 1;
+        }
+        lines_[match].support += segment_length;
+        segment_line_[index] = match;
+    }
+    
+    // Keep the best supported lines, strongest first. segment_order_ is
+    // reused to map each original line to its rank.
+    const size_t kept = std::min(kMaxLines, lines_.size());
+    std::vector<int>& rank = segment_order_;
+    rank.resize(lines_.size());
+    std::iota(rank.begin(), rank.end(), 0);
+    std::sort(rank.begin(), rank.end(), [&](int a, int b) { return lines_[a].support > lines_[b].support; });
+    ranked_lines_.clear();
+    for (size_t i = 0; i < kept; ++i) {
+        ranked_lines_.push_back(lines_[rank[i]]);
+    }
+    line_rank_.assign(lines_.size(), -1);
+    for (size_t i = 0; i < kept; ++i) {
+        line_rank_[rank[i]] = static_cast<int>(i);
+    }
+    lines_.swap(ranked_lines_);
+    
+    // Group the member segments of each kept line contiguously
+    for (auto& line : lines_) {
+        line.segment_count = 0;
+    }
+    for (int& line : segment_line_) {
+        line = line >= 0 ? line_rank_[line] : -1;
+        if (line >= 0) {
+            ++lines_[line].segment_count;
+        }
+    }
+    int next = 0;
+    for (auto& line : lines_) {
+        line.first_segment = next;
+        next += line.segment_count;
+        line.segment_count = 0;
+    }
+    grouped_segments_.resize(next);
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        int line = segment_line_[i];
+        if (line >= 0) {
+            EdgeLine& owner = lines_[line];
+            grouped_segments_[owner.first_segment + owner.segment_count++] = segments_[i];
+        }
+    }
+    
+    return lines_.size() >= 4;
+}
+
+double LineDocumentDetector::sideCoverage(const EdgeLine& line, const cv::Point2d& from,
+                                          const cv::Point2d& to) const {
+    double side_length = cv::norm(to - from);
+    if (side_length <= 0.0) {
+        return 0.0;
+    }
+    
+    // Project the line's segments onto the side and add up their overlap
+    cv::Point2d direction = (to - from) * (1.0 / side_length);
+    double covered = 0.0;
+    for (int i = 0; i < line.segment_count; ++i) {
+        const cv::Vec4i& segment = grouped_segments_[line.first_segment + i];
+        double t1 = (cv::Point2d(segment[0], segment[1]) - from).dot(direction);
+        double t2 = (cv::Point2d(segment[2], segment[3]) - from).dot(direction);
+        double low = std::max(0.0, std::min(t1, t2));
+        double high = std::min(side_length, std::max(t1, t2));
+        if (high > low) {
+            covered += high - low;
+        }
+    }
+    return std::min(covered, side_length);
+}
+
+bool LineDocumentDetector::findBestQuad(const cv::Size& image_size, double scale, QuadCandidate& best) {
+    parallel_pairs_.clear();
+    for (size_t i = 0; i < lines_.size(); ++i) {
+        for (size_t j = i + 1; j < lines_.size(); ++j) {
+            if (angleBetween(lines_[i].angle, lines_[j].angle) < kParallelAngle) {
+                parallel_pairs_.emplace_back(static_cast<int>(i), static_cast<int>(j));
+            }
+        }
+    }
+    
+    // Area limits are configured in full-resolution pixels
+    const double min_area = settings_.min_contour_area * scale * scale;
+    const double max_area = settings_.max_contour_area * scale * scale;
+    const cv::Rect2d allowed(-kCornerMargin * image_size.width, -kCornerMargin * image_size.height,
+                             (1.0 + 2.0 * kCornerMargin) * image_size.width,
+                             (1.0 + 2.0 * kCornerMargin) * image_size.height);
+    
+    bool found = false;
+    for (size_t p = 0; p < parallel_pairs_.size(); ++p) {
+        for (size_t q = p + 1; q < parallel_pairs_.size(); ++q) {
+            const EdgeLine& a1 = lines_[parallel_pairs_[p].first];
+            const EdgeLine& a2 = lines_[parallel_pairs_[p].second];
+            const EdgeLine& b1 = lines_[parallel_pairs_[q].first];
+            const EdgeLine& b2 = lines_[parallel_pairs_[q].second];
+            if (angleBetween(a1.angle, b1.angle) < kCrossingAngle) {
+                continue;
+            }
+            
+            // Corners in cyclic order; side k runs from corner k to k + 1
+            QuadCandidate quad;
+            const EdgeLine* sides[4] = {&b1, &a2, &b2, &a1};
+            if (!intersectLines(a1.normal, a1.offset, b1.normal, b1.offset, quad.corners[0]) ||
+                !intersectLines(b1.normal, b1.offset, a2.normal, a2.offset, quad.corners[1]) ||
+                !intersectLines(a2.normal, a2.offset, b2.normal, b2.offset, quad.corners[2]) ||
+                !intersectLines(b2.normal, b2.offset, a1.normal, a1.offset, quad.corners[3])) {
+                continue;
+            }
+            
+            bool valid = true;
+            double turn = 0.0;
+            for (size_t k = 0; k < 4 && valid; ++k) {
+                const cv::Point2d& c0 = quad.corners[k];
+                const cv::Point2d& c1 = quad.corners[(k + 1) % 4];
+                const cv::Point2d& c2 = quad.corners[(k + 2) % 4];
+                double cross = (c1 - c0).cross(c2 - c1);
+                
+                // Convex: every turn in the same direction
+                valid = allowed.contains(c0) && cross != 0.0 && (turn == 0.0 || (cross > 0.0) == (turn > 0.0));
+                turn = cross;
+            }
+            if (!valid) {
+                continue;
+            }
+            
+            quad.area = std::abs(signedArea(quad.corners));
+            if (quad.area < min_area || quad.area > max_area) {
+                continue;
+            }
+            
+            double covered = 0.0;
+            double perimeter = 0.0;
+            for (size_t k = 0; k < 4 && valid; ++k) {
+                const cv::Point2d& from = quad.corners[k];
+                const cv::Point2d& to = quad.corners[(k + 1) % 4];
+                double side_length = cv::norm(to - from);
+                double side_covered = sideCoverage(*sides[k], from, to);
+                valid = side_covered >= kMinSideCoverage * side_length;
+                covered += side_covered;
+                perimeter += side_length;
+            }
+            if (!valid || perimeter <= 0.0) {
+                continue;
+            }
+            
+            // Best coverage wins; near-ties go to the larger quad
+            quad.coverage = covered / perimeter;
+            if (quad.coverage < settings_.line_min_coverage) {
+                continue;
+            }
+            if (!found || quad.coverage > best.coverage + 1e-3 ||
+                (quad.coverage > best.coverage - 1e-3 && quad.area > best.area)) {
+                best = quad;
+                found = true;
+            }
+        }
+    }
+    
+    return found;
+}
+
+} // namespace preprocessing
+} // namespace id_reader
@@ -0,0 +1,73 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_LINE_DOCUMENT_DETECTOR_H
+#define ID_READER_LINE_DOCUMENT_DETECTOR_H
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <vector>
+
+#include "document_detector_base.h"
+
+namespace id_reader {
+namespace preprocessing {
+
+// Line engine: straight edge segments from a probabilistic Hough transform
+// are merged into lines, and every combination of two roughly parallel pairs
+// is intersected into a candidate quadrilateral. A candidate only needs part
+// of its perimeter backed by edge segments, so a document with an edge
+// hidden under a finger or a corner cut off by the frame is still found. The
+// corners of a cut document are extrapolated and may lie outside the image.
+class LineDocumentDetector : public DocumentDetectorBase {
+public:
+    LineDocumentDetector();
+    explicit LineDocumentDetector(const DetectorSettings& settings);
+    ~LineDocumentDetector() override;
+    
+    bool detectDocumentInRegion(const cv::Mat& input_image, const cv::Rect& roi, DocumentBounds& bounds) override;
+    
+private:
+    // Collinear segments merged into one line, in normal form n.p = c
+    struct EdgeLine {
+        cv::Point2d normal;
+        double offset = 0.0;
+        double angle = 0.0;        // Direction in [0, pi)
+        double support = 0.0;      // Total length of the member segments
+        int first_segment = 0;     // Range in grouped_segments_
+        int segment_count = 0;
+    };
+    
+    struct QuadCandidate {
+        std::array<cv::Point2d, 4> corners;  // In cyclic order
+        double coverage = 0.0;               // Fraction of the perimeter on edge segments
+        double area = 0.0;
+    };
+    
+    bool extractLines(const cv::Mat& edges);
+    bool findBestQuad(const cv::Size& image_size, double scale, QuadCandidate& best);
+    double sideCoverage(const EdgeLine& line, const cv::Point2d& from, const cv::Point2d& to) const;
+    
+    // Line engine scratch, reused across calls like the shared buffers
+    cv::Mat edges_;
+    std::vector<cv::Vec4i> segments_;
+    std::vector<int> segment_line_;
+    std::vector<int> segment_order_;
+    std::vector<int> line_rank_;
+    std::vector<cv::Vec4i> grouped_segments_;
+    std::vector<EdgeLine> lines_;
+    std::vector<EdgeLine> ranked_lines_;
+    std::vector<std::pair<int, int>> parallel_pairs_;
+};
+
+} // namespace preprocessing
+} // namespace id_reader
+
+#endif // ID_READER_LINE_DOCUMENT_DETECTOR_H
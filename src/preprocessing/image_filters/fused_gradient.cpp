@@ -0,0 +1,162 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "fused_gradient.h"
+#include <algorithm>
+
+// The row kernels are plain loops over contiguous arrays written so the
+// compiler vectorizes them. On x86-64 an AVX2 clone is built alongside the
+// baseline SSE2 version and picked at load time; NEON is part of the AArch64
+// baseline and needs no dispatch. ID_READER_NO_SIMD_CLONES builds the
+// baseline version only, which lets tests cover it on AVX2 machines.
+#if defined(__x86_64__) && defined(__ELF__) && defined(__has_attribute) && !defined(ID_READER_NO_SIMD_CLONES)
+#if __has_attribute(target_clones)
+#define ID_READER_SIMD_CLONES __attribute__((target_clones("avx2", "default")))
+#endif
+#endif
+#ifndef ID_READER_SIMD_CLONES
+#define ID_READER_SIMD_CLONES
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ID_READER_RESTRICT __restrict__
+#elif defined(_MSC_VER)
+#define ID_READER_RESTRICT __restrict
+#else
+#define ID_READER_RESTRICT
+#endif
+
+namespace id_reader {
+namespace preprocessing {
+
+namespace {
+
+// BORDER_REFLECT_101 index mapping (cv::GaussianBlur's default border)
+int reflect101(int index, int size) {
+    if (size == 1) {
+        return 0;
+    }
+    while (index < 0 || index >= size) {
+        index = index < 0 ? -index : 2 * size - 2 - index;
+    }
+    return index;
+}
+
+int ringSlot(int row, int ring_size) {
+    int slot = row % ring_size;
+    return slot < 0 ? slot + ring_size : slot;
+}
+
+// Horizontal [1 4 6 4 1] pass; `padded` holds width + 4 pixels
+ID_READER_SIMD_CLONES
+void blurRowHorizontal(const uint8_t* ID_READER_RESTRICT padded,
+                       uint16_t* ID_READER_RESTRICT out, int width) {
+    for (int x = 0; x < width; ++x) {
+        out[x] = static_cast<uint16_t>(padded[x] + padded[x + 4] +
+                                       4 * (padded[x + 1] + padded[x + 3]) +
+                                       6 * padded[x + 2]);
+    }
+}
+
+// Vertical [1 4 6 4 1] pass over five horizontal rows, rounded back to 8-bit
+// range: the 2D kernel sums to 256. The largest intermediate (255 * 256 + 128)
+// still fits in 16 bits.
+ID_READER_SIMD_CLONES
+void blurRowVertical(const uint16_t* ID_READER_RESTRICT r0, const uint16_t* ID_READER_RESTRICT r1,
+                     const uint16_t* ID_READER_RESTRICT r2, const uint16_t* ID_READER_RESTRICT r3,
+                     const uint16_t* ID_READER_RESTRICT r4, int16_t* ID_READER_RESTRICT out, int width) {
+    for (int x = 0; x < width; ++x) {
+        uint16_t sum = static_cast<uint16_t>(r0[x] + r4[x] + 4 * (r1[x] + r3[x]) + 6 * r2[x] + 128);
+        out[x] = static_cast<int16_t>(sum >> 8);
+    }
+}
+
+// 3x3 Sobel on blurred rows that carry one replicated pixel on each side
+ID_READER_SIMD_CLONES
+void sobelRow(const int16_t* ID_READER_RESTRICT up, const int16_t* ID_READER_RESTRICT mid,
+              const int16_t* ID_READER_RESTRICT down, int16_t* ID_READER_RESTRICT dx,
+              int16_t* ID_READER_RESTRICT dy, int width) {
+    for (int x = 0; x < width; ++x) {
+        dx[x] = static_cast<int16_t>((up[x + 2] - up[x]) + 2 * (mid[x + 2] - mid[x]) +
+                                     (down[x + 2] - down[x]));
+        dy[x] = static_cast<int16_t>((down[x] + 2 * down[x + 1] + down[x + 2]) -
+                                     (up[x] + 2 * up[x + 1] + up[x + 2]));
+    }
+}
+
+} // namespace
+
+void fusedBlurSobel(const cv::Mat& luma, cv::Mat& dx, cv::Mat& dy, FusedGradientScratch& scratch) {
+    CV_Assert(luma.type() == CV_8UC1);
+    dx.create(luma.size(), CV_16SC1);
+    dy.create(luma.size(), CV_16SC1);
+    fusedBlurSobelRows(luma, 0, luma.rows, dx, dy, scratch);
+}
+
+void fusedBlurSobelRows(const cv::Mat& luma, int row_begin, int row_end,
+                        cv::Mat& dx, cv::Mat& dy, FusedGradientScratch& scratch) {
+    CV_Assert(luma.type() == CV_8UC1);
+    CV_Assert(dx.type() == CV_16SC1 && dx.size() == luma.size());
+    CV_Assert(dy.type() == CV_16SC1 && dy.size() == luma.size());
+    
+    const int width = luma.cols;
+    const int height = luma.rows;
+    row_begin = std::max(row_begin, 0);
+    row_end = std::min(row_end, height);
+    if (width == 0 || row_begin >= row_end) {
+        return;
+    }
+    
+    const size_t blurred_stride = static_cast<size_t>(width) + 2;
+    scratch.padded_row.resize(static_cast<size_t>(width) + 4);
+    scratch.horizontal.resize(5 * static_cast<size_t>(width));
+    scratch.blurred.resize(3 * blurred_stride);
+    
+    uint8_t* padded = scratch.padded_row.data();
+    auto horizontal = [&](int row) { return scratch.horizontal.data() + ringSlot(row, 5) * width; };
+    auto blurred = [&](int row) { return scratch.blurred.data() + ringSlot(row, 3) * blurred_stride; };
+    
+    // Blurred rows are needed one above and one below each output row, with
+    // replicated image borders (as cv::Canny's Sobel). Each blurred row in
+    // turn needs horizontal rows two above and below it, reflected at the
+    // image border (as cv::GaussianBlur).
+    int next_horizontal = std::max(row_begin - 1, 0) - 2;
+    int next_blurred = std::max(row_begin - 1, 0);
+    
+    for (int y = row_begin; y < row_end; ++y) {
+        const int below = std::min(y + 1, height - 1);
+        
+        while (next_blurred <= below) {
+            for (; next_horizontal <= next_blurred + 2; ++next_horizontal) {
+                const uint8_t* src = luma.ptr<uint8_t>(reflect101(next_horizontal, height));
+                padded[0] = src[reflect101(-2, width)];
+                padded[1] = src[reflect101(-1, width)];
+                std::copy(src, src + width, padded + 2);
+                padded[width + 2] = src[reflect101(width, width)];
+                padded[width + 3] = src[reflect101(width + 1, width)];
+                blurRowHorizontal(padded, horizontal(next_horizontal), width);
+            }
+            
+            int16_t* out = blurred(next_blurred);
+            blurRowVertical(horizontal(next_blurred - 2), horizontal(next_blurred - 1),
+                            horizontal(next_blurred), horizontal(next_blurred + 1),
+                            horizontal(next_blurred + 2), out + 1, width);
+            out[0] = out[1];
+            out[width + 1] = out[width];
+            ++next_blurred;
+        }
+        
+        sobelRow(blurred(std::max(y - 1, 0)), blurred(y), blurred(below),
+                 dx.ptr<int16_t>(y), dy.ptr<int16_t>(y), width);
+    }
+}
+
+} // namespace preprocessing
+} // namespace id_reader
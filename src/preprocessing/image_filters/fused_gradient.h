@@ -0,0 +1,46 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_FUSED_GRADIENT_H
+#define ID_READER_FUSED_GRADIENT_H
+
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace id_reader {
+namespace preprocessing {
+
+// Row buffers for the fused kernel, reused across calls
+struct FusedGradientScratch {
+    std::vector<uint8_t> padded_row;     // One luma row with reflected borders
+    std::vector<uint16_t> horizontal;    // 5 rows blurred horizontally
+    std::vector<int16_t> blurred;        // 3 fully blurred rows with replicated borders
+};
+
+// 5x5 Gaussian blur followed by 3x3 Sobel gradients of a CV_8UC1 image in one
+// streaming pass. Only five horizontally blurred rows and three blurred rows
+// are live at any time, so no full-size blurred image is written or re-read.
+// Rounding and borders follow cv::GaussianBlur(src, dst, Size(5, 5), 0) and
+// the Sobel pass inside cv::Canny, making dx/dy suitable for the
+// cv::Canny(dx, dy, ...) overload. dx and dy are (re)allocated as CV_16SC1.
+void fusedBlurSobel(const cv::Mat& luma, cv::Mat& dx, cv::Mat& dy, FusedGradientScratch& scratch);
+
+// Same as fusedBlurSobel, but only output rows [row_begin, row_end) are
+// written; dx and dy must already be CV_16SC1 of the image size. Rows outside
+// the range are read from `luma` as needed, so disjoint ranges can be
+// computed concurrently with one scratch per thread.
+void fusedBlurSobelRows(const cv::Mat& luma, int row_begin, int row_end,
+                        cv::Mat& dx, cv::Mat& dy, FusedGradientScratch& scratch);
+
+} // namespace preprocessing
+} // namespace id_reader
+
+#endif // ID_READER_FUSED_GRADIENT_H
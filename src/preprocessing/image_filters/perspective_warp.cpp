@@ -0,0 +1,127 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "perspective_warp.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace id_reader {
+namespace preprocessing {
+
+namespace {
+
+// Source coordinates carry 5 fractional bits, the same sub-pixel grid as
+// cv::warpPerspective's INTER_BITS
+constexpr int kFracBits = 5;
+constexpr int kFracScale = 1 << kFracBits;
+constexpr int kFracMask = kFracScale - 1;
+constexpr int kWeightShift = 2 * kFracBits;
+constexpr int kWeightRound = 1 << (kWeightShift - 1);
+
+// Homography rows for one destination row: the homogeneous source point at
+// x = 0 and its step per destination pixel
+struct RowMapping {
+    double x, y, w;
+    double dx, dy, dw;
+};
+
+RowMapping rowMapping(const double* m, int row) {
+    return {m[1] * row + m[2], m[4] * row + m[5], m[7] * row + m[8], m[0], m[3], m[6]};
+}
+
+template <int CN>
+void warpRowNearest(const cv::Mat& src, RowMapping map, uint8_t* out, int width) {
+    const double max_x = src.cols - 1;
+    const double max_y = src.rows - 1;
+    
+    for (int x = 0; x < width; ++x, map.x += map.dx, map.y += map.dy, map.w += map.dw) {
+        double inv_w = map.w != 0.0 ? 1.0 / map.w : 0.0;
+        int sx = cvRound(std::min(std::max(map.x * inv_w, 0.0), max_x));
+        int sy = cvRound(std::min(std::max(map.y * inv_w, 0.0), max_y));
+        
+        const uint8_t* pixel = src.ptr<uint8_t>(sy) + sx * CN;
+        for (int c = 0; c < CN; ++c) {
+            out[x * CN + c] = pixel[c];
+        }
+    }
+}
+
+template <int CN>
+void warpRowBilinear(const cv::Mat& src, RowMapping map, uint8_t* out, int width) {
+    const int max_x = src.cols - 1;
+    const int max_y = src.rows - 1;
+    // Clamping one pixel past the image keeps the fixed-point conversion in
+    // range however far outside the source a sample lands
+    const double lo = -1.0;
+    const double hi_x = src.cols;
+    const double hi_y = src.rows;
+    
+    for (int x = 0; x < width; ++x, map.x += map.dx, map.y += map.dy, map.w += map.dw) {
+        double inv_w = map.w != 0.0 ? 1.0 / map.w : 0.0;
+        int fx = cvRound(std::min(std::max(map.x * inv_w, lo), hi_x) * kFracScale);
+        int fy = cvRound(std::min(std::max(map.y * inv_w, lo), hi_y) * kFracScale);
+        int ix = fx >> kFracBits;
+        int iy = fy >> kFracBits;
+        int ax = fx & kFracMask;
+        int ay = fy & kFracMask;
+        
+        int x0 = std::min(std::max(ix, 0), max_x);
+        int x1 = std::min(std::max(ix + 1, 0), max_x);
+        const uint8_t* row0 = src.ptr<uint8_t>(std::min(std::max(iy, 0), max_y));
+        const uint8_t* row1 = src.ptr<uint8_t>(std::min(std::max(iy + 1, 0), max_y));
+        
+        for (int c = 0; c < CN; ++c) {
+            int top = row0[x0 * CN + c] * (kFracScale - ax) + row0[x1 * CN + c] * ax;
+            int bottom = row1[x0 * CN + c] * (kFracScale - ax) + row1[x1 * CN + c] * ax;
+            out[x * CN + c] = static_cast<uint8_t>((top * (kFracScale - ay) + bottom * ay + kWeightRound) >> kWeightShift);
+        }
+    }
+}
+
+template <int CN>
+void warpRows(const cv::Mat& src, const double* m, WarpInterpolation interpolation, cv::Mat& dst) {
+    for (int y = 0; y < dst.rows; ++y) {
+        uint8_t* out = dst.ptr<uint8_t>(y);
+        if (interpolation == WarpInterpolation::Nearest) {
+            warpRowNearest<CN>(src, rowMapping(m, y), out, dst.cols);
+        } else {
+            warpRowBilinear<CN>(src, rowMapping(m, y), out, dst.cols);
+        }
+    }
+}
+
+} // namespace
+
+void warpPerspectiveFixed(const cv::Mat& src, const cv::Mat& dst_to_src, const cv::Size& size,
+                          WarpInterpolation interpolation, cv::Mat& dst) {
+    CV_Assert(src.depth() == CV_8U && !src.empty());
+    CV_Assert(dst_to_src.rows == 3 && dst_to_src.cols == 3 && dst_to_src.type() == CV_64FC1);
+    
+    dst.create(size, src.type());
+    cv::Mat m = dst_to_src.isContinuous() ? dst_to_src : dst_to_src.clone();
+    const double* coefficients = m.ptr<double>();
+    
+    switch (src.channels()) {
+        case 1:
+            warpRows<1>(src, coefficients, interpolation, dst);
+            break;
+        case 3:
+            warpRows<3>(src, coefficients, interpolation, dst);
+            break;
+        case 4:
+            warpRows<4>(src, coefficients, interpolation, dst);
+            break;
+        default:
+            CV_Assert(!"unsupported channel count");
+    }
+}
+
+} // namespace preprocessing
+} // namespace id_reader
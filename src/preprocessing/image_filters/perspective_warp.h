@@ -0,0 +1,39 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_PERSPECTIVE_WARP_H
+#define ID_READER_PERSPECTIVE_WARP_H
+
+#include <opencv2/opencv.hpp>
+
+namespace id_reader {
+namespace preprocessing {
+
+enum class WarpInterpolation {
+    Nearest,
+    Bilinear
+};
+
+// Perspective warp of a CV_8UC1/3/4 image into `dst` of the given size.
+// `dst_to_src` is the 3x3 CV_64F homography taking destination pixel
+// coordinates to source ones (cv::WARP_INVERSE_MAP convention). Source
+// coordinates are rounded to 1/32 pixel and bilinear weights are applied in
+// integer arithmetic, so results stay within one level of
+// cv::warpPerspective(..., INTER_LINEAR | WARP_INVERSE_MAP, BORDER_REPLICATE).
+// Samples outside the source repeat its edge pixels. dst is (re)allocated
+// with src's type only when it does not already match, so a Mat wrapping
+// caller memory of the right size and type is written in place.
+void warpPerspectiveFixed(const cv::Mat& src, const cv::Mat& dst_to_src, const cv::Size& size,
+                          WarpInterpolation interpolation, cv::Mat& dst);
+
+} // namespace preprocessing
+} // namespace id_reader
+
+#endif // ID_READER_PERSPECTIVE_WARP_H
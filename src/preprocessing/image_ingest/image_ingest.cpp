@@ -0,0 +1,72 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "image_ingest.h"
+#include <opencv2/opencv.hpp>
+#include <opencv2/imgproc.hpp>
+
+namespace id_reader {
+namespace preprocessing {
+
+bool ingestLuma(const id_reader_image_t& image, cv::Mat& luma) {
+    const int rows = static_cast<int>(image.height);
+    const int cols = static_cast<int>(image.width);
+
+    // Wrap the caller's buffer; the color conversions below read it once and
+    // write straight to luma, so no intermediate BGR image is ever built.
+    switch (image.format) {
+        case ID_READER_IMAGE_FORMAT_RGB:
+            cv::cvtColor(cv::Mat(rows, cols, CV_8UC3, image.data, image.stride), luma, cv::COLOR_RGB2GRAY);
+            return true;
+        case ID_READER_IMAGE_FORMAT_RGBA:
+            cv::cvtColor(cv::Mat(rows, cols, CV_8UC4, image.data, image.stride), luma, cv::COLOR_RGBA2GRAY);
+            return true;
+        case ID_READER_IMAGE_FORMAT_BGR:
+            cv::cvtColor(cv::Mat(rows, cols, CV_8UC3, image.data, image.stride), luma, cv::COLOR_BGR2GRAY);
+            return true;
+        case ID_READER_IMAGE_FORMAT_BGRA:
+            cv::cvtColor(cv::Mat(rows, cols, CV_8UC4, image.data, image.stride), luma, cv::COLOR_BGRA2GRAY);
+            return true;
+        case ID_READER_IMAGE_FORMAT_GRAYSCALE:
+        case ID_READER_IMAGE_FORMAT_NV12:
+        case ID_READER_IMAGE_FORMAT_NV21:
+        case ID_READER_IMAGE_FORMAT_I420:
+            // Already luma (or a Y plane, whose chroma detection never needs):
+            // share the caller's memory
+            luma = cv::Mat(rows, cols, CV_8UC1, image.data, image.stride);
+            return true;
+        default:
+            return false;
+    }
+}
+
+bool wrapPackedPixels(const id_reader_image_t& image, cv::Mat& pixels) {
+    const int rows = static_cast<int>(image.height);
+    const int cols = static_cast<int>(image.width);
+
+    switch (image.format) {
+        case ID_READER_IMAGE_FORMAT_RGB:
+        case ID_READER_IMAGE_FORMAT_BGR:
+            pixels = cv::Mat(rows, cols, CV_8UC3, image.data, image.stride);
+            return true;
+        case ID_READER_IMAGE_FORMAT_RGBA:
+        case ID_READER_IMAGE_FORMAT_BGRA:
+            pixels = cv::Mat(rows, cols, CV_8UC4, image.data, image.stride);
+            return true;
+        case ID_READER_IMAGE_FORMAT_GRAYSCALE:
+            pixels = cv::Mat(rows, cols, CV_8UC1, image.data, image.stride);
+            return true;
+        default:
+            return false;
+    }
+}
+
+} // namespace preprocessing
+} // namespace id_reader
@@ -0,0 +1,35 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_IMAGE_INGEST_H
+#define ID_READER_IMAGE_INGEST_H
+
+#include "id_reader/id_reader.h"
+#include <opencv2/opencv.hpp>
+
+namespace id_reader {
+namespace preprocessing {
+
+// Produce the single-channel luma plane used by detection directly from the
+// caller's pixel buffer. Grayscale input and the Y plane of YUV input are
+// wrapped without copying; packed color formats are converted in one pass
+// into `luma`, whose buffer is reused when it already has the right size.
+// Returns false for unsupported formats.
+bool ingestLuma(const id_reader_image_t& image, cv::Mat& luma);
+
+// Wrap the caller's pixels, without copying, as a CV_8UC1/3/4 Mat with the
+// image's own channel order. Returns false for YUV and unsupported formats,
+// which have no single packed plane holding every channel.
+bool wrapPackedPixels(const id_reader_image_t& image, cv::Mat& pixels);
+
+} // namespace preprocessing
+} // namespace id_reader
+
+#endif // ID_READER_IMAGE_INGEST_H
@@ -0,0 +1,119 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "quality_assessor.h"
+#include <algorithm>
+
+namespace id_reader {
+namespace preprocessing {
+
+namespace {
+
+double clamp01(double value) {
+    return std::min(1.0, std::max(0.0, value));
+}
+
+// Each term maps its threshold to 0.5, so the overall score (the weakest
+// term) is at least 0.5 exactly when every check passes
+double sharpnessTerm(double sharpness, double min_sharpness) {
+    if (min_sharpness <= 0.0) {
+        return 1.0;
+    }
+    return sharpness / (sharpness + min_sharpness);
+}
+
+double glareTerm(double glare_ratio, double max_glare_ratio) {
+    if (max_glare_ratio <= 0.0) {
+        return glare_ratio > 0.0 ? 0.0 : 1.0;
+    }
+    return clamp01(1.0 - glare_ratio / (2.0 * max_glare_ratio));
+}
+
+double exposureTerm(double brightness, double min_brightness, double max_brightness) {
+    if (brightness < min_brightness) {
+        return min_brightness > 0.0 ? 0.5 * brightness / min_brightness : 0.0;
+    }
+    if (brightness > max_brightness) {
+        return max_brightness < 255.0 ? 0.5 * (255.0 - brightness) / (255.0 - max_brightness) : 0.0;
+    }
+    double half_band = 0.5 * (max_brightness - min_brightness);
+    if (half_band <= 0.0) {
+        return 0.5;
+    }
+    double margin = std::min(brightness - min_brightness, max_brightness - brightness);
+    return 0.5 + 0.5 * clamp01(margin / half_band);
+}
+
+} // namespace
+
+void QualityAssessor::assess(const cv::Mat& luma, const QualitySettings& settings, QualityReport& report) {
+    report = QualityReport();
+    if (luma.empty()) {
+        report.reasons = kQualityBlurry | kQualityTooDark;
+        return;
+    }
+    
+    // INTER_AREA averages whole source blocks, so the decimated plane keeps
+    // the exposure of the original and blur still shows up as weak edges
+    const cv::Mat* plane = &luma;
+    int longer = std::max(luma.cols, luma.rows);
+    if (settings.max_dimension > 0 && longer > settings.max_dimension) {
+        double scale = static_cast<double>(settings.max_dimension) / longer;
+        cv::resize(luma, decimated_, cv::Size(), scale, scale, cv::INTER_AREA);
+        plane = &decimated_;
+    }
+    
+    cv::Laplacian(*plane, laplacian_, CV_16S);
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(laplacian_, mean, stddev);
+    report.sharpness = stddev[0] * stddev[0];
+    
+    // One pass over the plane for both glare and exposure
+    histogram_.fill(0);
+    for (int y = 0; y < plane->rows; ++y) {
+        const uint8_t* row = plane->ptr<uint8_t>(y);
+        for (int x = 0; x < plane->cols; ++x) {
+            ++histogram_[row[x]];
+        }
+    }
+    
+    const double pixels = static_cast<double>(plane->total());
+    const int glare_level = std::min(255, std::max(0, settings.glare_level));
+    uint64_t glare = 0;
+    uint64_t sum = 0;
+    for (int level = 0; level < 256; ++level) {
+        sum += static_cast<uint64_t>(level) * histogram_[level];
+        if (level >= glare_level) {
+            glare += histogram_[level];
+        }
+    }
+    report.glare_ratio = glare / pixels;
+    report.brightness = sum / pixels;
+    
+    if (report.sharpness < settings.min_sharpness) {
+        report.reasons |= kQualityBlurry;
+    }
+    if (report.glare_ratio > settings.max_glare_ratio) {
+        report.reasons |= kQualityGlare;
+    }
+    if (report.brightness < settings.min_brightness) {
+        report.reasons |= kQualityTooDark;
+    } else if (report.brightness > settings.max_brightness) {
+        report.reasons |= kQualityTooBright;
+    }
+    
+    double score = std::min({sharpnessTerm(report.sharpness, settings.min_sharpness),
+                             glareTerm(report.glare_ratio, settings.max_glare_ratio),
+                             exposureTerm(report.brightness, settings.min_brightness, settings.max_brightness)});
+    report.score = static_cast<float>(score);
+}
+
+} // namespace preprocessing
+} // namespace id_reader
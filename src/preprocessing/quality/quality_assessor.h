@@ -0,0 +1,73 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_QUALITY_ASSESSOR_H
+#define ID_READER_QUALITY_ASSESSOR_H
+
+#include <opencv2/opencv.hpp>
+#include <array>
+#include <cstdint>
+
+namespace id_reader {
+namespace preprocessing {
+
+// Reasons a frame failed the quality thresholds, as bit flags matching
+// id_reader_quality_reason_t
+enum QualityReason : uint32_t {
+    kQualityOk = 0,
+    kQualityBlurry = 1u << 0,
+    kQualityGlare = 1u << 1,
+    kQualityTooDark = 1u << 2,
+    kQualityTooBright = 1u << 3
+};
+
+struct QualitySettings {
+    bool gate_enabled = false;       // Reject failing frames before detection
+    int max_dimension = 480;         // Longer side of the decimated plane that is measured
+    double min_sharpness = 100.0;    // Laplacian variance
+    int glare_level = 250;           // Luma at or above which a pixel counts as specular
+    double max_glare_ratio = 0.05;   // Fraction of glare pixels
+    double min_brightness = 40.0;    // Mean luma
+    double max_brightness = 220.0;
+};
+
+struct QualityReport {
+    double sharpness = 0.0;     // Variance of the Laplacian of the decimated plane
+    double glare_ratio = 0.0;   // Fraction of pixels at or above glare_level
+    double brightness = 0.0;    // Mean luma
+    float score = 0.0f;         // 0-1, the weakest check; at least 0.5 when all pass
+    uint32_t reasons = kQualityOk;
+    
+    bool acceptable() const { return reasons == kQualityOk; }
+};
+
+// Cheap frame-level checks run before detection: sharpness from the
+// Laplacian variance, specular glare and exposure from a luma histogram, all
+// on a plane decimated to at most max_dimension on its longer side. Owns its
+// scratch planes, so one assessor per session.
+class QualityAssessor {
+public:
+    QualityAssessor() = default;
+    
+    QualityAssessor(const QualityAssessor&) = delete;
+    QualityAssessor& operator=(const QualityAssessor&) = delete;
+    
+    void assess(const cv::Mat& luma, const QualitySettings& settings, QualityReport& report);
+    
+private:
+    cv::Mat decimated_;
+    cv::Mat laplacian_;
+    std::array<uint32_t, 256> histogram_{};
+};
+
+} // namespace preprocessing
+} // namespace id_reader
+
+#endif // ID_READER_QUALITY_ASSESSOR_H
@@ -0,0 +1,138 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#include "document_rectifier.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace id_reader {
+namespace preprocessing {
+
+namespace {
+
+constexpr double kMillimetersPerInch = 25.4;
+
+struct FormatSize {
+    double width_mm;
+    double height_mm;
+};
+
+constexpr FormatSize kId1 = {85.60, 53.98};
+constexpr FormatSize kTd3 = {125.0, 88.0};
+
+// Smallest quad side, in pixels, that still defines a usable homography
+constexpr double kMinSidePixels = 2.0;
+
+double sideLength(const cv::Point2f& a, const cv::Point2f& b) {
+    return std::hypot(static_cast<double>(a.x - b.x), static_cast<double>(a.y - b.y));
+}
+
+} // namespace
+
+cv::Size rectifiedSize(DocumentFormat format, double dpi) {
+    const FormatSize& size = format == DocumentFormat::Td3 ? kTd3 : kId1;
+    return cv::Size(std::max(1, static_cast<int>(std::lround(size.width_mm * dpi / kMillimetersPerInch))),
+                    std::max(1, static_cast<int>(std::lround(size.height_mm * dpi / kMillimetersPerInch))));
+}
+
+DocumentFormat DocumentRectifier::resolveFormat(DocumentFormat format, const DocumentBounds& bounds,
+                                                const cv::Size& image_size) {
+    if (format != DocumentFormat::Auto) {
+        return format;
+    }
+    
+    const float w = static_cast<float>(image_size.width);
+    const float h = static_cast<float>(image_size.height);
+    double horizontal = sideLength(cv::Point2f(bounds.x1 * w, bounds.y1 * h), cv::Point2f(bounds.x2 * w, bounds.y2 * h)) +
+                        sideLength(cv::Point2f(bounds.x4 * w, bounds.y4 * h), cv::Point2f(bounds.x3 * w, bounds.y3 * h));
+    double vertical = sideLength(cv::Point2f(bounds.x2 * w, bounds.y2 * h), cv::Point2f(bounds.x3 * w, bounds.y3 * h)) +
+                      sideLength(cv::Point2f(bounds.x1 * w, bounds.y1 * h), cv::Point2f(bounds.x4 * w, bounds.y4 * h));
+    double aspect = std::max(horizontal, vertical) / std::max(std::min(horizontal, vertical), 1e-9);
+    
+    // Compare in log space so being 10% too wide counts the same as 10% too narrow
+    double to_id1 = std::abs(std::log(aspect * kId1.height_mm / kId1.width_mm));
+    double to_td3 = std::abs(std::log(aspect * kTd3.height_mm / kTd3.width_mm));
+    return to_td3 < to_id1 ? DocumentFormat::Td3 : DocumentFormat::Id1;
+}
+
+bool DocumentRectifier::rectify(const cv::Mat& image, const DocumentBounds& bounds,
+                                const RectifySettings& settings, cv::Mat& output) {
+    if (image.empty() || (settings.size.empty() && settings.dpi <= 0.0)) {
+        return false;
+    }
+    
+    const float w = static_cast<float>(image.cols);
+    const float h = static_cast<float>(image.rows);
+    cv::Point2f quad[4] = {
+        cv::Point2f(bounds.x1 * w, bounds.y1 * h),
+        cv::Point2f(bounds.x2 * w, bounds.y2 * h),
+        cv::Point2f(bounds.x3 * w, bounds.y3 * h),
+        cv::Point2f(bounds.x4 * w, bounds.y4 * h)
+    };
+    for (int i = 0; i < 4; ++i) {
+        if (sideLength(quad[i], quad[(i + 1) % 4]) < kMinSidePixels) {
+            return false;
+        }
+    }
+    
+    // Start from the corner that makes the first side one of the long pair,
+    // keeping the clockwise order
+    double horizontal = sideLength(quad[0], quad[1]) + sideLength(quad[3], quad[2]);
+    double vertical = sideLength(quad[1], quad[2]) + sideLength(quad[0], quad[3]);
+    if (vertical > horizontal) {
+        cv::Point2f first = quad[0];
+        quad[0] = quad[3];
+        quad[3] = quad[2];
+        quad[2] = quad[1];
+        quad[1] = first;
+    }
+    
+    cv::Size size = settings.size;
+    if (size.empty()) {
+        size = rectifiedSize(resolveFormat(settings.format, bounds, image.size()), settings.dpi);
+    }
+    const float dst_w = static_cast<float>(size.width);
+    const float dst_h = static_cast<float>(size.height);
+    cv::Point2f target[4] = {
+        cv::Point2f(0.0f, 0.0f),
+        cv::Point2f(dst_w, 0.0f),
+        cv::Point2f(dst_w, dst_h),
+        cv::Point2f(0.0f, dst_h)
+    };
+    
+    // Destination-to-source mapping, as the warp samples the source per output pixel
+    homography_ = cv::getPerspectiveTransform(target, quad);
+    if (homography_.empty() || !cv::checkRange(homography_)) {
+        return false;
+    }
+    
+    warpPerspectiveFixed(image, homography_, size, settings.interpolation, output);
+    return true;
+}
+
+cv::Rect DocumentRectifier::sourceRect(const cv::Rect& rect) const {
+    if (homography_.empty()) {
+        return cv::Rect();
+    }
+    
+    std::vector<cv::Point2f> corners = {
+        cv::Point2f(static_cast<float>(rect.x), static_cast<float>(rect.y)),
+        cv::Point2f(static_cast<float>(rect.x + rect.width), static_cast<float>(rect.y)),
+        cv::Point2f(static_cast<float>(rect.x + rect.width), static_cast<float>(rect.y + rect.height)),
+        cv::Point2f(static_cast<float>(rect.x), static_cast<float>(rect.y + rect.height))
+    };
+    std::vector<cv::Point2f> mapped;
+    cv::perspectiveTransform(corners, mapped, homography_);
+    return cv::boundingRect(mapped);
+}
+
+} // namespace preprocessing
+} // namespace id_reader
@@ -0,0 +1,68 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ */
+
+#ifndef ID_READER_DOCUMENT_RECTIFIER_H
+#define ID_READER_DOCUMENT_RECTIFIER_H
+
+#include <opencv2/opencv.hpp>
+
+#include "../document_detection/document_detector_base.h"
+#include "../image_filters/perspective_warp.h"
+
+namespace id_reader {
+namespace preprocessing {
+
+// Physical document sizes from ISO/IEC 7810
+enum class DocumentFormat {
+    Auto,  // Whichever of the formats below the quad's aspect is closer to
+    Id1,   // 85.60 x 53.98 mm: ID cards, driver's licenses
+    Td3    // 125 x 88 mm: passport data pages
+};
+
+struct RectifySettings {
+    DocumentFormat format = DocumentFormat::Auto;
+    double dpi = 300.0;
+    WarpInterpolation interpolation = WarpInterpolation::Bilinear;
+    cv::Size size;  // Exact crop size, overriding the format's size at `dpi`; empty: unused
+};
+
+// Landscape pixel size of a format at the given resolution. Auto is not a
+// size; it is resolved against a quad first.
+cv::Size rectifiedSize(DocumentFormat format, double dpi);
+
+// Produces a deskewed, fixed-resolution crop of a detected document. The
+// homography is rebuilt per call; the rectifier holds no other state, so one
+// per session is enough.
+class DocumentRectifier {
+public:
+    // Resolve Auto to ID-1 or TD3 from the quad's side lengths in `image_size`
+    // pixels
+    static DocumentFormat resolveFormat(DocumentFormat format, const DocumentBounds& bounds,
+                                        const cv::Size& image_size);
+    
+    // Map the quad in `bounds` (normalized to `image`) onto a landscape crop
+    // of the resolved format. The quad's longer side pair becomes the crop's
+    // width, so a document photographed in portrait comes out rotated by a
+    // quarter turn. `output` keeps its buffer when its size and type already
+    // match. Returns false for a degenerate quad.
+    bool rectify(const cv::Mat& image, const DocumentBounds& bounds, const RectifySettings& settings,
+                 cv::Mat& output);
+    
+    // Bounding box, in source image pixels, of `rect` in the most recent crop
+    cv::Rect sourceRect(const cv::Rect& rect) const;
+    
+private:
+    cv::Mat homography_;
+};
+
+} // namespace preprocessing
+} // namespace id_reader
+
+#endif // ID_READER_DOCUMENT_RECTIFIER_H
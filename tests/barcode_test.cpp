@@ -0,0 +1,446 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * PDF417 Barcode Test
+ * Checks Reed-Solomon correction over GF(929) with errors and erasures, the
+ * text, byte and numeric compaction modes, the AAMVA header, directory and
+ * date handling, and reads a rendered AAMVA symbol end to end, with a smudge
+ * hiding a column. The ISO 15438 codeword table is not shipped, so the
+ * symbol is drawn with a stand-in table of valid codeword patterns: the
+ * reader only needs the table to be a bijection per cluster.
+ */
+
+#include "extraction/barcode/aamva_parser.h"
+#include "extraction/barcode/pdf417_compaction.h"
+#include "extraction/barcode/pdf417_error_correction.h"
+#include "extraction/barcode/pdf417_reader.h"
+#include "test_check.h"
+#include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace id_reader::extraction;
+
+namespace {
+
+int power3(int exponent) {
+    int value = 1;
+    for (int i = 0; i < exponent; ++i) {
+        value = value * 3 % kPdf417CodewordCount;
+    }
+    return value;
+}
+
+// Append `ec_count` error correction codewords: the remainder of the data
+// times x^ec_count divided by the generator, the product of (x - 3^i)
+std::vector<int> withErrorCorrection(const std::vector<int>& data, int ec_count) {
+    const int m = kPdf417CodewordCount;
+    std::vector<int> generator = {1};  // Highest degree first
+    for (int i = 1; i <= ec_count; ++i) {
+        std::vector<int> next(generator.size() + 1, 0);
+        int root = power3(i);
+        for (size_t j = 0; j < generator.size(); ++j) {
+            next[j] = (next[j] + generator[j]) % m;
+            next[j + 1] = (next[j + 1] + m - generator[j] * root % m) % m;
+        }
+        generator = next;
+    }
+    std::vector<int> remainder = data;
+    remainder.resize(data.size() + ec_count, 0);
+    for (size_t i = 0; i < data.size(); ++i) {
+        int coefficient = remainder[i];
+        for (size_t j = 0; j < generator.size(); ++j) {
+            remainder[i + j] = (remainder[i + j] + m - coefficient * generator[j] % m) % m;
+        }
+    }
+    std::vector<int> symbol = data;
+    for (int i = 0; i < ec_count; ++i) {
+        symbol.push_back((m - remainder[data.size() + i]) % m);
+    }
+    return symbol;
+}
+
+// Byte compaction: six bytes to five base 900 codewords, the rest one each
+// under 901; 924 when the length is a multiple of six
+std::vector<int> byteCompaction(const std::string& bytes) {
+    std::vector<int> codewords = {bytes.size() % 6 == 0 ? 924 : 901};
+    size_t singles = bytes.size() % 6;
+    size_t i = 0;
+    for (; i + 6 <= bytes.size() - singles; i += 6) {
+        uint64_t value = 0;
+        for (size_t k = 0; k < 6; ++k) {
+            value = value * 256 + static_cast<unsigned char>(bytes[i + k]);
+        }
+        int group[5];
+        for (int k = 4; k >= 0; --k) {
+            group[k] = static_cast<int>(value % 900);
+            value /= 900;
+        }
+        codewords.insert(codewords.end(), group, group + 5);
+    }
+    for (; i < bytes.size(); ++i) {
+        codewords.push_back(static_cast<unsigned char>(bytes[i]));
+    }
+    return codewords;
+}
+
+void testErrorCorrection() {
+    std::mt19937 rng(929);
+    for (int level = 1; level <= 5; ++level) {
+        const int ec_count = 2 << level;
+        for (int trial = 0; trial < 50; ++trial) {
+            std::vector<int> data(1 + rng() % 100);
+            for (int& codeword : data) {
+                codeword = rng() % kPdf417CodewordCount;
+            }
+            const std::vector<int> original = withErrorCorrection(data, ec_count);
+            const int n = static_cast<int>(original.size());
+            std::vector<int> positions(n);
+            for (int i = 0; i < n; ++i) {
+                positions[i] = i;
+            }
+            std::shuffle(positions.begin(), positions.end(), rng);
+            auto corrupt = [&](std::vector<int>& codewords, int begin, int end) {
+                for (int i = begin; i < end && i < n; ++i) {
+                    int& codeword = codewords[positions[i]];
+                    codeword = (codeword + 1 + rng() % (kPdf417CodewordCount - 1)) % kPdf417CodewordCount;
+                }
+            };
+            
+            // Up to ec_count / 2 errors anywhere are corrected
+            std::vector<int> codewords = original;
+            int errors = std::min<int>(rng() % (ec_count / 2 + 1), n);
+            corrupt(codewords, 0, errors);
+            CHECK_EQ(correctPdf417Errors(codewords, ec_count), errors);
+            CHECK(codewords == original);
+            
+            // One more is detected, not miscorrected
+            if (n > ec_count / 2) {
+                codewords = original;
+                corrupt(codewords, 0, ec_count / 2 + 1);
+                CHECK_EQ(correctPdf417Errors(codewords, ec_count), -1);
+            }
+            
+            // Erasures cost one codeword each: ec_count - 2 of them still
+            // leave room for one unknown error
+            if (n > ec_count) {
+                codewords = original;
+                std::vector<int> erasures(positions.begin(), positions.begin() + ec_count - 2);
+                for (int i : erasures) {
+                    codewords[i] = 0;
+                }
+                corrupt(codewords, ec_count - 2, ec_count - 1);
+                CHECK(correctPdf417Errors(codewords, ec_count, erasures) >= 1);
+                CHECK(codewords == original);
+            }
+        }
+    }
+    
+    // Codewords out of range, a symbol shorter than its error correction,
+    // erasures outside the symbol or more of them than can be corrected
+    std::vector<int> original = withErrorCorrection({5, 100, 200, 300, 400}, 8);
+    std::vector<int> codewords = original;
+    codewords[2] = kPdf417CodewordCount;
+    CHECK_EQ(correctPdf417Errors(codewords, 8), -1);
+    codewords = {1, 2, 3};
+    CHECK_EQ(correctPdf417Errors(codewords, 4), -1);
+    codewords = original;
+    codewords[0] = 0;
+    CHECK_EQ(correctPdf417Errors(codewords, 8, {static_cast<int>(codewords.size())}), -1);
+    CHECK_EQ(correctPdf417Errors(codewords, 8, {0, 1, 2, 3, 4, 5, 6, 7, 8}), -1);
+    CHECK_EQ(correctPdf417Errors(codewords, 8, {0}), 1);
+    CHECK(codewords == original);
+}
+
+bool decodes(std::vector<int> codewords, const std::string& expected) {
+    codewords.insert(codewords.begin(), static_cast<int>(codewords.size()) + 1);
+    std::string data;
+    return CHECK(decodePdf417Data(codewords, data)) && CHECK(data == expected);
+}
+
+void testCompaction() {
+    // Text: "AB" in upper case, "A" then latch to lower case (27), "b" then
+    // latch to mixed (28), "1" then the punctuation shift as padding
+    decodes({1, 27, 58, 59}, "ABAb1");
+    // Shift to punctuation for "@", a byte shift for LF, then "A" padded
+    decodes({873, 913, 10, 29}, "@\nA");
+    
+    // Byte: "ABCDEF" as five base 900 codewords, "G" on its own under 901
+    std::vector<int> group = byteCompaction("ABCDEF");
+    group.erase(group.begin());
+    std::vector<int> bytes = {901};
+    bytes.insert(bytes.end(), group.begin(), group.end());
+    bytes.push_back('G');
+    decodes(bytes, "ABCDEFG");
+    bytes = {924};
+    bytes.insert(bytes.end(), group.begin(), group.end());
+    decodes(bytes, "ABCDEF");
+    decodes(byteCompaction("@\n\x1e\rANSI "), "@\n\x1e\rANSI ");
+    
+    // Numeric: "000213298174000" is 1000213298174000 in base 900
+    std::vector<int> numeric;
+    for (uint64_t value = 1000213298174000ULL; value > 0; value /= 900) {
+        numeric.insert(numeric.begin(), static_cast<int>(value % 900));
+    }
+    numeric.insert(numeric.begin(), 902);
+    decodes(numeric, "000213298174000");
+    
+    // Macro PDF417 control data ends the message
+    decodes({1, 928, 111, 100}, "AB");
+    
+    // Malformed: length descriptor past the end, reserved codeword
+    std::string data;
+    CHECK(!decodePdf417Data({5, 1}, data));
+    CHECK(!decodePdf417Data({0}, data));
+    CHECK(!decodePdf417Data({2, 903}, data));
+}
+
+const AamvaField* findField(const AamvaData& data, const std::string& name) {
+    for (const AamvaField& field : data.fields) {
+        if (field.name == name) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+std::string fieldValue(const AamvaData& data, const std::string& name) {
+    const AamvaField* field = findField(data, name);
+    return field ? field->value : "<missing>";
+}
+
+const std::string kUsSubfile =
+    "DLDAQD12345678\nDCSSMITH\nDACJOHN\nDADQUINCY\nDBD01152020\nDBB07041980\nDBA07042028\n"
+    "DBC1\nDAYBLU\nDAU070 in\nDAG123 MAIN ST\nDAIANYTOWN\nDAJVA\nDAK222220000  \nDCGUSA\nDCFXYZ\r";
+
+// Version 2 onwards: IIN, version, jurisdiction version, one entry
+std::string usPayload(const std::string& offset) {
+    return std::string("@\n\x1e\rANSI 636000090001DL") + offset + "0" + std::to_string(kUsSubfile.size()) +
+           kUsSubfile;
+}
+
+void testAamva() {
+    AamvaData data;
+    CHECK(parseAamva(usPayload("0031"), data));
+    CHECK_EQ(data.issuer_id, std::string("636000"));
+    CHECK_EQ(data.version, 9);
+    CHECK(data.drivers_license);
+    CHECK(!data.canadian);
+    CHECK_EQ(fieldValue(data, "document_number"), std::string("D12345678"));
+    CHECK_EQ(fieldValue(data, "surname"), std::string("SMITH"));
+    CHECK_EQ(fieldValue(data, "given_names"), std::string("JOHN QUINCY"));
+    CHECK_EQ(fieldValue(data, "date_of_birth"), std::string("19800704"));  // From MMDDCCYY
+    CHECK_EQ(fieldValue(data, "date_of_expiry"), std::string("20280704"));
+    CHECK_EQ(fieldValue(data, "sex"), std::string("M"));
+    CHECK_EQ(fieldValue(data, "postal_code"), std::string("222220000"));
+    
+    // Version 1: no jurisdiction version, full name in DAA, and a Canadian
+    // jurisdiction writing CCYYMMDD. The directory offset is two short and
+    // the length runs past the end.
+    const std::string canadian = "@\n\x1e\rANSI 6360270101DL00290100DLDAANUMBER,ONE,M\nDAQ123\nDBB19800704\nDAJON\r";
+    CHECK(parseAamva(canadian, data));
+    CHECK_EQ(data.version, 1);
+    CHECK(data.canadian);
+    CHECK_EQ(fieldValue(data, "surname"), std::string("NUMBER"));
+    CHECK_EQ(fieldValue(data, "given_names"), std::string("ONE M"));
+    CHECK_EQ(fieldValue(data, "date_of_birth"), std::string("19800704"));
+    
+    // Version 1 US documents write CCYYMMDD as well
+    const std::string us_v1 = "@\n\x1e\rANSI 6360000101DL00310100DLDAQD1234\nDCSDOE\nDBB19800704\nDBA20280704\nDAJVA\r";
+    CHECK(parseAamva(us_v1, data));
+    CHECK_EQ(data.version, 1);
+    CHECK(!data.canadian);
+    CHECK_EQ(fieldValue(data, "date_of_birth"), std::string("19800704"));
+    CHECK_EQ(fieldValue(data, "date_of_expiry"), std::string("20280704"));
+    
+    // A directory offset past the payload, or off by a few, falls back to
+    // finding the subfile; without one the payload is rejected, not thrown on
+    CHECK(parseAamva(usPayload("9990"), data));
+    CHECK_EQ(fieldValue(data, "document_number"), std::string("D12345678"));
+    CHECK(parseAamva(usPayload("0035"), data));
+    CHECK_EQ(fieldValue(data, "document_number"), std::string("D12345678"));
+    CHECK(!parseAamva("@\n\x1e\rANSI 636000090001DL99990100", data));
+    CHECK(!parseAamva("@\n\x1e\rANSI 6360", data));
+    CHECK(!parseAamva("not a barcode", data));
+}
+
+// Stand-in codeword table: per cluster, the first 929 patterns of four bars
+// and four spaces of 1-6 modules in 17 whose (e0 - e2 + e4 - e6) mod 9 is
+// the cluster number
+struct TestCodebook {
+    std::vector<uint32_t> patterns[3];
+    
+    TestCodebook() {
+        int widths[8];
+        enumerate(widths, 0, 0);
+    }
+    
+    void enumerate(int* widths, int index, int modules) {
+        if (index == 8) {
+            int cluster = ((widths[0] - widths[2] + widths[4] - widths[6]) % 9 + 9) % 9;
+            if (modules != 17 || cluster % 3 != 0 ||
+                static_cast<int>(patterns[cluster / 3].size()) == kPdf417CodewordCount) {
+                return;
+            }
+            uint32_t pattern = 0;
+            for (int element = 0; element < 8; ++element) {
+                for (int module = 0; module < widths[element]; ++module) {
+                    pattern = (pattern << 1) | (element % 2 == 0 ? 1 : 0);
+                }
+            }
+            patterns[cluster / 3].push_back(pattern);
+            return;
+        }
+        for (int width = 1; width <= 6 && modules + width <= 17; ++width) {
+            widths[index] = width;
+            enumerate(widths, index + 1, modules + width);
+        }
+    }
+};
+
+// Draw `modules` bits of `pattern` (first module in the highest bit) as
+// dark bars, `scale` pixels per module; returns the x after it
+int drawModules(cv::Mat& image, int x, int y, int height, int scale, uint32_t pattern, int modules) {
+    for (int module = modules - 1; module >= 0; --module, x += scale) {
+        if (((pattern >> module) & 1) == 0) {
+            continue;
+        }
+        for (int row = y; row < y + height; ++row) {
+            uchar* pixels = image.ptr<uchar>(row);
+            std::fill(pixels + x, pixels + x + scale, static_cast<uchar>(30));
+        }
+    }
+    return x;
+}
+
+// A PDF417 symbol of `codewords` (data and error correction) with noise
+cv::Mat renderSymbol(const TestCodebook& codebook, const std::vector<int>& codewords, int rows, int columns,
+                     int error_level, std::mt19937& rng) {
+    const uint32_t kStart = 0x1fea8;  // 8 1 1 1 1 1 1 3
+    const uint32_t kStop = 0x3fa29;   // 7 1 1 3 1 1 1 2 1
+    const int scale = 3;
+    const int row_height = 3 * scale;
+    const int quiet = 30;
+    cv::Mat image(rows * row_height + 2 * quiet, 2 * quiet + scale * (17 * (columns + 3) + 18), CV_8UC1,
+                  cv::Scalar(220));
+    for (int row = 0; row < rows; ++row) {
+        const int cluster = row % 3;
+        const int group = row / 3 * 30;
+        const int row_info = error_level * 3 + (rows - 1) % 3;
+        const int indicators[3][2] = {
+            {(rows - 1) / 3, columns - 1},
+            {row_info, (rows - 1) / 3},
+            {columns - 1, row_info}
+        };
+        const int y = quiet + row * row_height;
+        int x = drawModules(image, quiet, y, row_height, scale, kStart, 17);
+        std::vector<int> line = {group + indicators[cluster][0]};
+        line.insert(line.end(), codewords.begin() + row * columns, codewords.begin() + (row + 1) * columns);
+        line.push_back(group + indicators[cluster][1]);
+        for (int codeword : line) {
+            x = drawModules(image, x, y, row_height, scale, codebook.patterns[cluster][codeword], 17);
+        }
+        drawModules(image, x, y, row_height, scale, kStop, 18);
+    }
+    for (int y = 0; y < image.rows; ++y) {
+        uchar* pixels = image.ptr<uchar>(y);
+        for (int x = 0; x < image.cols; ++x) {
+            pixels[x] = static_cast<uchar>(std::min(255, std::max(0, pixels[x] + static_cast<int>(rng() % 41) - 20)));
+        }
+    }
+    return image;
+}
+
+// A dark smudge over symbol data column `column` and everything right of
+// it, keeping the space that ends the column before
+void addSmudge(cv::Mat& image, int column) {
+    const int begin = 30 + 3 * 17 * (column + 2);
+    for (int y = 0; y < image.rows; ++y) {
+        uchar* pixels = image.ptr<uchar>(y);
+        std::fill(pixels + begin, pixels + image.cols, static_cast<uchar>(30));
+    }
+}
+
+void testSymbol() {
+    TestCodebook codebook;
+    for (const auto& cluster : codebook.patterns) {
+        CHECK_EQ(static_cast<int>(cluster.size()), kPdf417CodewordCount);
+    }
+    std::vector<uint32_t> table;
+    for (const auto& cluster : codebook.patterns) {
+        table.insert(table.end(), cluster.begin(), cluster.end());
+    }
+    Pdf417Codebook book;
+    CHECK(book.loadPatterns(table.data(), table.size()));
+    
+    // A driver's licence payload in byte compaction, padded with 900 to
+    // fill the rows
+    const std::string payload = usPayload("0031");
+    const int columns = 8;
+    const int error_level = 4;
+    const int ec_count = 2 << error_level;
+    std::vector<int> data = {0};
+    std::vector<int> bytes = byteCompaction(payload);
+    data.insert(data.end(), bytes.begin(), bytes.end());
+    const int rows = (static_cast<int>(data.size()) + ec_count + columns - 1) / columns;
+    data.resize(rows * columns - ec_count, 900);
+    data[0] = static_cast<int>(data.size());
+    std::vector<int> codewords = withErrorCorrection(data, ec_count);
+    
+    std::mt19937 rng(417);
+    Pdf417Reader reader;
+    Pdf417Symbol symbol;
+    cv::Mat image = renderSymbol(codebook, codewords, rows, columns, error_level, rng);
+    CHECK(reader.read(image, book, symbol));
+    CHECK_EQ(symbol.rows, rows);
+    CHECK_EQ(symbol.columns, columns);
+    CHECK_EQ(symbol.error_level, error_level);
+    CHECK_EQ(symbol.corrected, 0);
+    CHECK(symbol.data == payload);
+    AamvaData aamva;
+    CHECK(parseAamva(symbol.data, aamva) && fieldValue(aamva, "surname") == "SMITH");
+    
+    // Upside down
+    cv::rotate(image, image, cv::ROTATE_180);
+    CHECK(reader.read(image, book, symbol));
+    CHECK(symbol.data == payload);
+    
+    // A smudge over the last data column: more unread cells than half the error
+    // correction, which only reading them as erasures can restore
+    CHECK(rows > ec_count / 2);
+    image = renderSymbol(codebook, codewords, rows, columns, error_level, rng);
+    addSmudge(image, columns - 1);
+    CHECK(reader.read(image, book, symbol));
+    CHECK_EQ(symbol.erased, rows);
+    CHECK(symbol.data == payload);
+    CHECK(symbol.confidence() < 1.0f);
+    
+    // Plus two misprinted codewords elsewhere
+    std::vector<int> damaged = codewords;
+    damaged[1] = (damaged[1] + 1) % kPdf417CodewordCount;
+    damaged[columns + 2] = (damaged[columns + 2] + 7) % kPdf417CodewordCount;
+    image = renderSymbol(codebook, damaged, rows, columns, error_level, rng);
+    addSmudge(image, columns - 1);
+    CHECK(reader.read(image, book, symbol));
+    CHECK_EQ(symbol.corrected, rows + 2);
+    CHECK(symbol.data == payload);
+    
+    // Two columns hidden is beyond repair
+    image = renderSymbol(codebook, codewords, rows, columns, error_level, rng);
+    addSmudge(image, columns - 2);
+    CHECK(!reader.read(image, book, symbol));
+}
+
+} // namespace
+
+int main() {
+    testErrorCorrection();
+    testCompaction();
+    testAamva();
+    testSymbol();
+    return test::result();
+}
@@ -0,0 +1,268 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * MRZ Reader Test
+ * Checks the ICAO 9303 parser against the specimen documents of parts 4
+ * and 5 (check digits, field split, composite check), the runner-up repair
+ * in MrzReader::decode, and segmentation and template matching on a
+ * synthetic passport MRZ band.
+ */
+
+#include "extraction/mrz/mrz_parser.h"
+#include "extraction/mrz/mrz_reader.h"
+#include "extraction/ocr/field_layout.h"
+#include "preprocessing/rectification/document_rectifier.h"
+#include "test_check.h"
+#include <opencv2/opencv.hpp>
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace id_reader::extraction;
+
+namespace {
+
+// ICAO 9303 specimens
+const std::vector<std::string> kTd3Lines = {
+    "P<UTOERIKSSON<<ANNA<MARIA<<<<<<<<<<<<<<<<<<<",
+    "L898902C36UTO7408122F1204159ZE184226B<<<<<10"
+};
+const std::vector<std::string> kTd1Lines = {
+    "I<UTOD231458907<<<<<<<<<<<<<<<",
+    "7408122F1204159UTO<<<<<<<<<<<6",
+    "ERIKSSON<<ANNA<MARIA<<<<<<<<<<"
+};
+
+const MrzField* findField(const MrzData& data, const std::string& name) {
+    for (const MrzField& field : data.fields) {
+        if (field.name == name) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+std::string fieldValue(const MrzData& data, const std::string& name) {
+    const MrzField* field = findField(data, name);
+    return field ? field->value : "<missing>";
+}
+
+bool fieldValid(const MrzData& data, const std::string& name) {
+    const MrzField* field = findField(data, name);
+    return field && field->valid;
+}
+
+void testCheckDigits() {
+    CHECK_EQ(mrzCheckDigit("L898902C3", 0, 9), 6);
+    CHECK_EQ(mrzCheckDigit("740812", 0, 6), 2);
+    CHECK_EQ(mrzCheckDigit("120415", 0, 6), 9);
+    CHECK_EQ(mrzCheckDigit("ZE184226B<<<<<", 0, 14), 1);
+    CHECK_EQ(mrzCheckDigit("D23145890", 0, 9), 7);
+    CHECK_EQ(mrzCheckDigit(kTd3Lines[1], 13, 6), 2);  // Offset into a line
+    CHECK_EQ(mrzCheckDigit("<<<<<<", 0, 6), 0);
+    CHECK_EQ(mrzCheckDigit("74o812", 0, 6), -1);      // Not an MRZ character
+    CHECK_EQ(mrzCheckDigit("740812", 2, 6), -1);      // Past the end
+}
+
+void testTd3() {
+    MrzData data;
+    CHECK(parseMrz(MrzFormat::Td3, kTd3Lines, data));
+    CHECK(data.composite_valid);
+    CHECK(data.valid());
+    CHECK_EQ(fieldValue(data, "document_code"), std::string("P"));
+    CHECK_EQ(fieldValue(data, "issuing_country"), std::string("UTO"));
+    CHECK_EQ(fieldValue(data, "surname"), std::string("ERIKSSON"));
+    CHECK_EQ(fieldValue(data, "given_names"), std::string("ANNA MARIA"));
+    CHECK_EQ(fieldValue(data, "document_number"), std::string("L898902C3"));
+    CHECK_EQ(fieldValue(data, "nationality"), std::string("UTO"));
+    CHECK_EQ(fieldValue(data, "date_of_birth"), std::string("740812"));
+    CHECK_EQ(fieldValue(data, "sex"), std::string("F"));
+    CHECK_EQ(fieldValue(data, "date_of_expiry"), std::string("120415"));
+    CHECK_EQ(fieldValue(data, "personal_number"), std::string("ZE184226B"));
+    
+    // A wrong field check digit fails that field and the composite
+    std::vector<std::string> lines = kTd3Lines;
+    lines[1][19] = '3';
+    CHECK(parseMrz(MrzFormat::Td3, lines, data));
+    CHECK(!fieldValid(data, "date_of_birth"));
+    CHECK(fieldValid(data, "document_number"));
+    CHECK(!data.composite_valid);
+    CHECK(!data.valid());
+    
+    // A wrong composite digit fails only the composite
+    lines = kTd3Lines;
+    lines[1][43] = '1';
+    CHECK(parseMrz(MrzFormat::Td3, lines, data));
+    CHECK(fieldValid(data, "date_of_birth") && fieldValid(data, "date_of_expiry"));
+    CHECK(!data.composite_valid);
+    CHECK(!data.valid());
+    
+    // Layouts that do not fit the format
+    CHECK(!parseMrz(MrzFormat::Td3, {kTd3Lines[0]}, data));
+    CHECK(!parseMrz(MrzFormat::Td3, {kTd3Lines[0], kTd3Lines[1].substr(1)}, data));
+    CHECK(!parseMrz(MrzFormat::Td3, kTd1Lines, data));
+}
+
+void testTd1() {
+    MrzData data;
+    CHECK(parseMrz(MrzFormat::Td1, kTd1Lines, data));
+    CHECK(data.composite_valid);
+    CHECK(data.valid());
+    CHECK_EQ(fieldValue(data, "document_code"), std::string("I"));
+    CHECK_EQ(fieldValue(data, "document_number"), std::string("D23145890"));
+    CHECK_EQ(fieldValue(data, "date_of_birth"), std::string("740812"));
+    CHECK_EQ(fieldValue(data, "sex"), std::string("F"));
+    CHECK_EQ(fieldValue(data, "date_of_expiry"), std::string("120415"));
+    CHECK_EQ(fieldValue(data, "nationality"), std::string("UTO"));
+    CHECK_EQ(fieldValue(data, "surname"), std::string("ERIKSSON"));
+    CHECK_EQ(fieldValue(data, "given_names"), std::string("ANNA MARIA"));
+    
+    // The TD1 composite covers the optional data of line 1 as well
+    std::vector<std::string> lines = kTd1Lines;
+    lines[0][20] = 'X';
+    CHECK(parseMrz(MrzFormat::Td1, lines, data));
+    CHECK(fieldValid(data, "document_number"));
+    CHECK(!data.composite_valid);
+    
+    CHECK(!parseMrz(MrzFormat::Td1, kTd3Lines, data));
+}
+
+// A reading as a recognizer would leave it: every character with a score
+// and, by default, no runner-up different from it
+MrzReading readingOf(MrzFormat format, const std::vector<std::string>& lines) {
+    MrzReading reading;
+    reading.format = format;
+    reading.lines = lines;
+    reading.alternates = lines;
+    for (const std::string& line : lines) {
+        reading.scores.emplace_back(line.size(), 0.9f);
+        reading.alternate_scores.emplace_back(line.size(), 0.1f);
+    }
+    return reading;
+}
+
+void testRepair() {
+    // Date of birth 740812 misread as 740312, with 8 the close runner-up; a
+    // second candidate in the field that would not fix the check is ignored
+    MrzReading reading = readingOf(MrzFormat::Td3, kTd3Lines);
+    reading.lines[1][16] = '3';
+    reading.alternates[1][16] = '8';
+    reading.scores[1][16] = 0.6f;
+    reading.alternate_scores[1][16] = 0.5f;
+    reading.alternates[1][14] = '5';
+    reading.alternate_scores[1][14] = 0.85f;
+    CHECK(MrzReader::decode(reading));
+    CHECK_EQ(reading.lines[1], kTd3Lines[1]);
+    CHECK(reading.data.valid());
+    CHECK(std::abs(reading.scores[1][16] - 0.5f) < 1e-6f);
+    CHECK(std::abs(reading.scores[1][14] - 0.9f) < 1e-6f);
+    
+    // The check digit itself may be the misread character
+    reading = readingOf(MrzFormat::Td1, kTd1Lines);
+    reading.lines[0][14] = '1';
+    reading.alternates[0][14] = '7';
+    reading.alternate_scores[0][14] = 0.8f;
+    CHECK(MrzReader::decode(reading));
+    CHECK_EQ(reading.lines[0], kTd1Lines[0]);
+    CHECK(reading.data.valid());
+    
+    // A runner-up far behind the first choice is not trusted
+    reading = readingOf(MrzFormat::Td3, kTd3Lines);
+    reading.lines[1][16] = '3';
+    reading.alternates[1][16] = '8';
+    reading.scores[1][16] = 0.9f;
+    reading.alternate_scores[1][16] = 0.2f;
+    CHECK(MrzReader::decode(reading));
+    CHECK_EQ(reading.lines[1][16], '3');
+    CHECK(!fieldValid(reading.data, "date_of_birth"));
+    
+    // Without runners-up the lines are only parsed
+    reading = readingOf(MrzFormat::Td3, kTd3Lines);
+    reading.lines[1][16] = '3';
+    reading.alternates.clear();
+    CHECK(MrzReader::decode(reading));
+    CHECK(!reading.data.valid());
+    
+    reading = readingOf(MrzFormat::Td3, {kTd3Lines[0]});
+    CHECK(!MrzReader::decode(reading));
+}
+
+// Text drawn one character per cell of `pitch` pixels, dark on white, as in
+// the benchmark; Hershey glyphs stand in for OCR-B in templates and band
+cv::Mat renderMrzText(const std::string& text, double pitch, int height) {
+    cv::Mat image(height, static_cast<int>(std::lround(pitch * text.size())), CV_8UC1, cv::Scalar(255));
+    for (size_t i = 0; i < text.size(); ++i) {
+        const std::string glyph(1, text[i]);
+        int baseline = 0;
+        cv::Size extent = cv::getTextSize(glyph, cv::FONT_HERSHEY_SIMPLEX, 1.0, 2, &baseline);
+        cv::Point origin(static_cast<int>(std::lround(i * pitch + (pitch - extent.width) / 2.0)),
+                         (height + extent.height) / 2);
+        cv::putText(image, glyph, origin, cv::FONT_HERSHEY_SIMPLEX, 1.0, cv::Scalar(0), 2, cv::LINE_AA);
+    }
+    return image;
+}
+
+void testSyntheticBand() {
+    using id_reader::preprocessing::DocumentFormat;
+    const double dpi = 300.0;
+    const double pitch = dpi / 10.0;
+    const int left = 20;
+    
+    MrzTemplates templates;
+    CHECK(templates.loadStrip(renderMrzText(kMrzAlphabet, pitch, static_cast<int>(pitch * 1.6))));
+    CHECK_EQ(templates.templates().rows, kMrzAlphabetSize);
+    
+    cv::Size crop_size = id_reader::preprocessing::rectifiedSize(DocumentFormat::Td3, dpi);
+    cv::Rect band_rect = fieldRect(fieldLayout(DocumentFormat::Td3).front(), crop_size);
+    cv::Mat band(band_rect.size(), CV_8UC1, cv::Scalar(255));
+    const int line_height = static_cast<int>(pitch * 1.2);
+    std::vector<int> line_tops;
+    for (size_t i = 0; i < kTd3Lines.size(); ++i) {
+        cv::Mat text = renderMrzText(kTd3Lines[i], pitch, line_height);
+        int y = band.rows - static_cast<int>((kTd3Lines.size() - i) * pitch * 1.5);
+        int width = std::min(text.cols, band.cols - left);
+        text(cv::Rect(0, 0, width, line_height)).copyTo(band(cv::Rect(left, y, width, line_height)));
+        line_tops.push_back(y);
+    }
+    cv::GaussianBlur(band, band, cv::Size(3, 3), 0.8);
+    
+    MrzReader reader;
+    MrzReading reading;
+    if (!CHECK(reader.segment(band, MrzFormat::Td3, dpi, reading))) {
+        return;
+    }
+    
+    // Two lines, each cut into 44 cells at the 10 cpi pitch, inside the rows
+    // the text was drawn in
+    CHECK_EQ(reading.layout.size(), kTd3Lines.size());
+    for (size_t l = 0; l < reading.layout.size() && l < line_tops.size(); ++l) {
+        const MrzLine& line = reading.layout[l];
+        CHECK_EQ(line.cells.size(), kTd3Lines[l].size());
+        CHECK(line.rect.y >= line_tops[l] - 3 && line.rect.br().y <= line_tops[l] + line_height + 3);
+        if (line.cells.size() < 2) {
+            continue;
+        }
+        double measured_pitch = static_cast<double>(line.cells.back().x - line.cells.front().x) /
+                                (line.cells.size() - 1);
+        CHECK(std::abs(measured_pitch - pitch) < 0.05 * pitch);
+        CHECK(std::abs(line.cells.front().x + line.cells.front().width / 2.0 - (left + pitch / 2)) < pitch / 3);
+    }
+    
+    reader.classify(templates, reading);
+    CHECK(MrzReader::decode(reading));
+    CHECK(reading.lines == kTd3Lines);
+    CHECK(reading.data.valid());
+    CHECK(reading.confidence(1, 0, 44) > 0.5f);
+}
+
+} // namespace
+
+int main() {
+    testCheckDigits();
+    testTd3();
+    testTd1();
+    testRepair();
+    testSyntheticBand();
+    return test::result();
+}
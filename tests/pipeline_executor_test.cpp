@@ -0,0 +1,214 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * Pipeline Executor Test
+ * Stresses the lock-free bounded queue with several producers and consumers,
+ * checks the Block, DropOldest and DropNewest entry policies of the staged
+ * pipeline, and that shutdown hands every item still queued to the drop
+ * callback: each submitted item must end up delivered or dropped exactly
+ * once.
+ */
+
+#include "core/bounded_queue.h"
+#include "core/pipeline_executor.h"
+#include "test_check.h"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using id_reader::core::BoundedQueue;
+using id_reader::core::PipelineExecutor;
+using id_reader::core::QueuePolicy;
+
+namespace {
+
+using Pipeline = PipelineExecutor<int>;
+
+// How many times each item id reached the end of the pipeline or was dropped
+struct Tally {
+    explicit Tally(int count) : delivered(count), dropped(count) {}
+    
+    std::vector<std::atomic<int>> delivered;
+    std::vector<std::atomic<int>> dropped;
+};
+
+int total(const std::vector<std::atomic<int>>& counts) {
+    int sum = 0;
+    for (const auto& count : counts) {
+        sum += count.load();
+    }
+    return sum;
+}
+
+void waitFor(const std::function<bool()>& done) {
+    while (!done()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void testQueueBasics() {
+    BoundedQueue<int> queue(5);
+    CHECK_EQ(queue.capacity(), 8u);
+    
+    int value = 0;
+    CHECK(!queue.tryPop(value));
+    for (int i = 0; i < 8; ++i) {
+        int item = i;
+        CHECK(queue.tryPush(item));
+    }
+    int extra = 8;
+    CHECK(!queue.tryPush(extra));
+    CHECK_EQ(extra, 8);  // Untouched when full
+    for (int i = 0; i < 8; ++i) {
+        CHECK(queue.tryPop(value));
+        CHECK_EQ(value, i);
+    }
+    CHECK(!queue.tryPop(value));
+}
+
+void testQueueStress() {
+    const int producers = 4;
+    const int consumers = 4;
+    const int per_producer = 100000;
+    const int count = producers * per_producer;
+    BoundedQueue<int> queue(64);
+    std::vector<std::atomic<int>> seen(count);
+    std::atomic<int> popped{0};
+    
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < per_producer; ++i) {
+                int item = p * per_producer + i;
+                while (!queue.tryPush(item)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c) {
+        threads.emplace_back([&] {
+            int item;
+            while (popped.load() < count) {
+                if (queue.tryPop(item)) {
+                    seen[item].fetch_add(1);
+                    popped.fetch_add(1);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    
+    int once = 0;
+    for (auto& count_seen : seen) {
+        once += count_seen.load() == 1 ? 1 : 0;
+    }
+    CHECK_EQ(once, count);
+    int leftover;
+    CHECK(!queue.tryPop(leftover));
+}
+
+// Two stages with several workers each, fed by several submitters through an
+// entry queue whose limit is not a power of two. With `stop_early` the
+// pipeline is destroyed straight after the last submission, so items still
+// queued are abandoned to the drop callback.
+void testPipeline(QueuePolicy policy, bool stop_early) {
+    const int submitters = 3;
+    const int per_submitter = 20000;
+    const int count = submitters * per_submitter;
+    Tally tally(count);
+    
+    auto pipeline = std::make_unique<Pipeline>(
+        std::vector<Pipeline::StageConfig>{
+            {3, [](int&, size_t) { return true; }},
+            {2, [&](int& item, size_t) { tally.delivered[item].fetch_add(1); return false; }}
+        },
+        13, policy, [&](int& item) { tally.dropped[item].fetch_add(1); });
+    
+    std::vector<std::thread> threads;
+    for (int s = 0; s < submitters; ++s) {
+        threads.emplace_back([&, s] {
+            for (int i = 0; i < per_submitter; ++i) {
+                pipeline->submit(s * per_submitter + i);
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    if (!stop_early) {
+        waitFor([&] { return total(tally.delivered) + total(tally.dropped) == count; });
+    }
+    pipeline.reset();
+    
+    int once = 0;
+    for (int i = 0; i < count; ++i) {
+        once += tally.delivered[i].load() + tally.dropped[i].load() == 1 ? 1 : 0;
+    }
+    CHECK_EQ(once, count);
+    if (policy == QueuePolicy::Block && !stop_early) {
+        CHECK_EQ(total(tally.dropped), 0);
+    }
+}
+
+// Which items an entry policy drops: one worker is held on item 0 while the
+// entry queue fills with 1 .. capacity, then two more are submitted. A
+// capacity that is not a power of two must still hold exactly that many.
+void testEntryPolicy(QueuePolicy policy, int capacity, const std::vector<int>& expected_dropped) {
+    const int count = capacity + 3;
+    Tally tally(count);
+    std::atomic<bool> started{false};
+    std::atomic<bool> release{false};
+    
+    Pipeline pipeline(
+        {{1, [&](int& item, size_t) {
+            if (item == 0) {
+                started.store(true);
+                waitFor([&] { return release.load(); });
+            }
+            tally.delivered[item].fetch_add(1);
+            return false;
+        }}},
+        capacity, policy, [&](int& item) { tally.dropped[item].fetch_add(1); });
+    
+    pipeline.submit(0);
+    waitFor([&] { return started.load(); });
+    for (int item = 1; item < count; ++item) {
+        pipeline.submit(item);
+    }
+    CHECK_EQ(total(tally.dropped), static_cast<int>(expected_dropped.size()));
+    release.store(true);
+    waitFor([&] { return total(tally.delivered) + total(tally.dropped) == count; });
+    
+    for (int item : expected_dropped) {
+        CHECK_EQ(tally.dropped[item].load(), 1);
+        CHECK_EQ(tally.delivered[item].load(), 0);
+    }
+    CHECK_EQ(tally.delivered[0].load(), 1);
+}
+
+} // namespace
+
+int main() {
+    testQueueBasics();
+    testQueueStress();
+    
+    for (QueuePolicy policy : {QueuePolicy::Block, QueuePolicy::DropOldest, QueuePolicy::DropNewest}) {
+        testPipeline(policy, false);
+        testPipeline(policy, true);
+    }
+    testEntryPolicy(QueuePolicy::DropNewest, 2, {3, 4});
+    testEntryPolicy(QueuePolicy::DropOldest, 2, {1, 2});
+    testEntryPolicy(QueuePolicy::DropNewest, 3, {4, 5});
+    testEntryPolicy(QueuePolicy::DropOldest, 3, {1, 2});
+    
+    return test::result();
+}
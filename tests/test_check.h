@@ -0,0 +1,55 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * Minimal checks for the unit tests: each test is a standalone program that
+ * reports every failed check and exits non-zero if there was one, which is
+ * all ctest needs.
+ */
+
+#ifndef ID_READER_TEST_CHECK_H
+#define ID_READER_TEST_CHECK_H
+
+#include <iostream>
+
+namespace test {
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+inline bool check(bool condition, const char* expression, const char* file, int line) {
+    if (!condition) {
+        std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+        ++failures();
+    }
+    return condition;
+}
+
+// Exit code for main
+inline int result() {
+    if (failures() > 0) {
+        std::cerr << failures() << " check(s) failed" << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+} // namespace test
+
+#define CHECK(condition) test::check(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+// Like CHECK, printing both values on failure
+#define CHECK_EQ(actual, expected)                                                               \
+    do {                                                                                         \
+        const auto& check_actual_ = (actual);                                                    \
+        const auto& check_expected_ = (expected);                                                \
+        if (!test::check(check_actual_ == check_expected_, #actual " == " #expected, __FILE__,   \
+                         __LINE__)) {                                                            \
+            std::cerr << "    actual: " << check_actual_ << ", expected: " << check_expected_    \
+                      << std::endl;                                                              \
+        }                                                                                        \
+    } while (0)
+
+#endif // ID_READER_TEST_CHECK_H
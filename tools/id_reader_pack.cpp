@@ -0,0 +1,172 @@
+/*
+ * Universal ID Reader - Cross-platform ID document scanner
+ * Copyright (C) 2025 J. Keith Lawson
+ *
+ * Asset Bundle Packer
+ * Writes the classifier model, MRZ glyph templates and PDF417 codeword table
+ * into one asset bundle for id_reader_init_with_bundle. Each asset can be
+ * keyed by document type and country with --for; assets given before any
+ * --for apply to every document.
+ */
+
+#include <id_reader/id_reader.h>
+#include "core/asset_bundle.h"
+#include "extraction/barcode/pdf417_reader.h"
+#include "extraction/mrz/mrz_reader.h"
+#include <opencv2/opencv.hpp>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using id_reader::core::AssetBundleEntry;
+using id_reader::core::AssetKind;
+
+namespace {
+
+void printUsage(const char* program) {
+    std::cout << "Usage: " << program << " OUTPUT [--for TYPE,COUNTRY] ASSET..." << std::endl
+              << "  --for TYPE,COUNTRY       Key the following assets, e.g. passport,any or drivers_license,us" << std::endl
+              << "                           Types: any, drivers_license, passport, id_card, credit_card" << std::endl
+              << "                           Countries: any, us, ca, gb, de, fr, au" << std::endl
+              << "  --model FILE             Document classifier (.tflite)" << std::endl
+              << "  --mrz-templates IMAGE    MRZ glyph strip, as for mrz_templates" << std::endl
+              << "  --pdf417-codebook FILE   PDF417 codeword table, as for pdf417_codebook" << std::endl;
+}
+
+bool parseDocumentType(const std::string& name, id_reader_document_type_t& type) {
+    static const std::pair<const char*, id_reader_document_type_t> kTypes[] = {
+        {"any", ID_READER_DOCUMENT_UNKNOWN},
+        {"drivers_license", ID_READER_DOCUMENT_DRIVERS_LICENSE},
+        {"passport", ID_READER_DOCUMENT_PASSPORT},
+        {"id_card", ID_READER_DOCUMENT_ID_CARD},
+        {"credit_card", ID_READER_DOCUMENT_CREDIT_CARD}
+    };
+    for (const auto& entry : kTypes) {
+        if (name == entry.first) {
+            type = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseCountry(const std::string& name, id_reader_country_t& country) {
+    static const std::pair<const char*, id_reader_country_t> kCountries[] = {
+        {"any", ID_READER_COUNTRY_UNKNOWN},
+        {"us", ID_READER_COUNTRY_US},
+        {"ca", ID_READER_COUNTRY_CA},
+        {"gb", ID_READER_COUNTRY_GB},
+        {"de", ID_READER_COUNTRY_DE},
+        {"fr", ID_READER_COUNTRY_FR},
+        {"au", ID_READER_COUNTRY_AU}
+    };
+    for (const auto& entry : kCountries) {
+        if (name == entry.first) {
+            country = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool readFile(const std::string& path, std::vector<uint8_t>& data) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !data.empty();
+}
+
+// Section payloads are stored exactly as the engine uses them in place
+bool packMrzTemplates(const std::string& path, std::vector<uint8_t>& data) {
+    id_reader::extraction::MrzTemplates templates;
+    if (!templates.load(path)) {
+        return false;
+    }
+    cv::Mat matrix = templates.templates().isContinuous() ? templates.templates() : templates.templates().clone();
+    data.resize(matrix.total() * matrix.elemSize());
+    std::memcpy(data.data(), matrix.data, data.size());
+    return true;
+}
+
+bool packPdf417Codebook(const std::string& path, std::vector<uint8_t>& data) {
+    std::vector<uint32_t> patterns;
+    if (!id_reader::extraction::readPdf417Patterns(path, patterns)) {
+        return false;
+    }
+    data.resize(patterns.size() * sizeof(uint32_t));
+    std::memcpy(data.data(), patterns.data(), data.size());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || std::string(argv[1]) == "--help") {
+        printUsage(argv[0]);
+        return argc < 2 ? 1 : 0;
+    }
+    
+    std::string output = argv[1];
+    id_reader_document_type_t type = ID_READER_DOCUMENT_UNKNOWN;
+    id_reader_country_t country = ID_READER_COUNTRY_UNKNOWN;
+    std::vector<AssetBundleEntry> entries;
+    
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            printUsage(argv[0]);
+            return 1;
+        }
+        std::string value = argv[++i];
+        
+        if (arg == "--for") {
+            size_t comma = value.find(',');
+            if (comma == std::string::npos || !parseDocumentType(value.substr(0, comma), type) ||
+                !parseCountry(value.substr(comma + 1), country)) {
+                std::cerr << "Invalid document key: " << value << std::endl;
+                return 1;
+            }
+            continue;
+        }
+        
+        AssetBundleEntry entry;
+        entry.document_type = type;
+        entry.country = country;
+        bool loaded;
+        if (arg == "--model") {
+            entry.kind = AssetKind::ClassifierModel;
+            loaded = readFile(value, entry.data);
+        } else if (arg == "--mrz-templates") {
+            entry.kind = AssetKind::MrzTemplates;
+            loaded = packMrzTemplates(value, entry.data);
+        } else if (arg == "--pdf417-codebook") {
+            entry.kind = AssetKind::Pdf417Codebook;
+            loaded = packPdf417Codebook(value, entry.data);
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+        if (!loaded) {
+            std::cerr << "Cannot load " << value << std::endl;
+            return 1;
+        }
+        entries.push_back(std::move(entry));
+    }
+    
+    if (entries.empty()) {
+        std::cerr << "No assets given" << std::endl;
+        return 1;
+    }
+    if (!id_reader::core::writeAssetBundle(output, entries)) {
+        std::cerr << "Cannot write " << output << std::endl;
+        return 1;
+    }
+    
+    std::cout << "Wrote " << entries.size() << " sections to " << output << std::endl;
+    return 0;
+}